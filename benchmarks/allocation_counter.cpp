@@ -0,0 +1,39 @@
+#include "allocation_counter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+std::atomic<std::size_t> g_allocation_count{0};
+std::atomic<std::size_t> g_allocated_bytes{0};
+} // namespace
+
+void *operator new(const std::size_t size) {
+    g_allocation_count.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+std::size_t allocation_count() noexcept {
+    return g_allocation_count.load(std::memory_order_relaxed);
+}
+
+std::size_t allocated_bytes() noexcept {
+    return g_allocated_bytes.load(std::memory_order_relaxed);
+}
+
+} // namespace inexor::vulkan_renderer::benchmarks
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstddef>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+/// Number of heap allocations done by the benchmark executable so far.
+[[nodiscard]] std::size_t allocation_count() noexcept;
+/// Number of bytes allocated on the heap by the benchmark executable so far, frees are not subtracted.
+[[nodiscard]] std::size_t allocated_bytes() noexcept;
+
+} // namespace inexor::vulkan_renderer::benchmarks
@@ -0,0 +1,94 @@
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/mesh_cache.hpp"
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
+#include "inexor/vulkan-renderer/octree_gpu_vertex.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+namespace {
+
+/// Generate the vertices and indices of an octree like the renderer does on start-up, but with a single color, so
+/// shared corners are merged.
+/// @return false if the mesh has too many vertices for std::uint32_t indices.
+bool generate_mesh(const world::Cube &cube, io::MeshCache::Mesh &mesh) {
+    mesh.vertices.clear();
+    mesh.indices.clear();
+    std::unordered_map<OctreeGpuVertex, std::uint32_t> vertex_map;
+    for (const auto &polygons : cube.polygons(true)) {
+        for (const auto &polygon : polygons) {
+            for (const auto &position : polygon) {
+                const OctreeGpuVertex vertex(position, {1.0F, 1.0F, 1.0F});
+                const auto [iter, inserted] = vertex_map.emplace(vertex, static_cast<std::uint32_t>(vertex_map.size()));
+                if (inserted) {
+                    if (vertex_map.size() > std::numeric_limits<std::uint32_t>::max()) {
+                        return false;
+                    }
+                    mesh.vertices.push_back(vertex);
+                }
+                mesh.indices.push_back(iter->second);
+            }
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+/// A start-up without the mesh cache: generate the polygons of the octree and merge the vertices.
+void BM_GenerateOctreeMesh(benchmark::State &state) {
+    io::MeshCache::Mesh mesh;
+    std::shared_ptr<world::Cube> cube;
+    for (auto _ : state) {
+        state.PauseTiming();
+        // Every start-up generates the polygons of a freshly loaded octree.
+        cube = tests::generate_architecture(static_cast<std::size_t>(state.range(0)));
+        state.ResumeTiming();
+        if (!generate_mesh(*cube, mesh)) {
+            state.SkipWithError("The mesh has too many vertices.");
+            return;
+        }
+        benchmark::DoNotOptimize(mesh);
+    }
+    state.counters["vertices"] = static_cast<double>(mesh.vertices.size());
+    state.counters["indices"] = static_cast<double>(mesh.indices.size());
+}
+
+/// A start-up with the mesh cache: serialize the octree for the key and load the entry.
+void BM_LoadCachedOctreeMesh(benchmark::State &state) {
+    const auto cube = tests::generate_architecture(static_cast<std::size_t>(state.range(0)));
+    io::MeshCache::Mesh mesh;
+    if (!generate_mesh(*cube, mesh)) {
+        state.SkipWithError("The mesh has too many vertices.");
+        return;
+    }
+    const auto directory = std::filesystem::temp_directory_path() / "inexor_benchmark_mesh_cache";
+    const io::MeshCache cache(directory);
+    cache.store("world", io::MeshCache::key(io::serialize_octree(cube, 0).data()), mesh.vertices, mesh.indices);
+    for (auto _ : state) {
+        const auto key = io::MeshCache::key(io::serialize_octree(cube, 0).data());
+        auto cached_mesh = cache.load("world", key);
+        if (!cached_mesh) {
+            state.SkipWithError("The mesh cache entry is stale.");
+            break;
+        }
+        benchmark::DoNotOptimize(cached_mesh);
+    }
+    state.counters["vertices"] = static_cast<double>(mesh.vertices.size());
+    state.counters["indices"] = static_cast<double>(mesh.indices.size());
+    std::filesystem::remove_all(directory);
+}
+
+BENCHMARK(BM_GenerateOctreeMesh)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadCachedOctreeMesh)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+
+} // namespace inexor::vulkan_renderer::benchmarks
@@ -0,0 +1,353 @@
+#include "../allocation_counter.hpp"
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/io/byte_sink.hpp"
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/compression.hpp"
+#include "inexor/vulkan-renderer/io/octree_index.hpp"
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/flat_octree.hpp"
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+void BM_SerializeOctree(benchmark::State &state) {
+    const std::shared_ptr<const world::Cube> cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        const io::ByteStream stream = io::serialize_octree(cube, 0);
+        bytes = stream.size();
+        benchmark::DoNotOptimize(stream);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+}
+
+void BM_DeserializeOctree(benchmark::State &state) {
+    const io::ByteStream stream =
+        io::serialize_octree(tests::generate_octree(static_cast<std::size_t>(state.range(0))), 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::deserialize_octree(stream));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * stream.size()));
+}
+
+/// Read format version 0 into the node pools of a flat octree instead of cubes.
+void BM_DeserializeFlatOctree(benchmark::State &state) {
+    const io::ByteStream stream =
+        io::serialize_octree(tests::generate_octree(static_cast<std::size_t>(state.range(0))), 0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::deserialize_flat_octree(stream));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * stream.size()));
+}
+
+/// Read the whole octree of format version 1.
+void BM_DeserializeIndexedOctree(benchmark::State &state) {
+    const io::ByteStream stream =
+        io::serialize_octree(tests::generate_octree(static_cast<std::size_t>(state.range(0))), 1);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::deserialize_octree(stream));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * stream.size()));
+}
+
+/// Read only the subtrees of format version 1 in the first octant of the octree.
+void BM_LoadIndexedOctreeRegion(benchmark::State &state) {
+    const io::ByteStream stream =
+        io::serialize_octree(tests::generate_octree(static_cast<std::size_t>(state.range(0))), 1);
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        io::OctreeIndex index(stream, std::make_shared<world::Cube>());
+        index.load_region(index.root()->position(), index.root()->position() + glm::vec3(index.root()->size() / 2));
+        bytes = 0;
+        for (std::size_t idx = 0; idx < index.subtree_count(); idx++) {
+            bytes += index.is_loaded(idx) ? index.subtree_size(idx) : 0;
+        }
+        benchmark::DoNotOptimize(index.root());
+    }
+    state.counters["loaded_bytes"] = static_cast<double>(bytes);
+}
+
+/// Read the subtrees on the default index level on a thread pool with the given number of workers.
+void BM_DeserializeOctreeParallel(benchmark::State &state) {
+    const io::ByteStream stream =
+        io::serialize_octree(tests::generate_octree(6), static_cast<std::uint32_t>(state.range(0)));
+    tools::ThreadPool thread_pool(static_cast<std::size_t>(state.range(1)));
+    // The parallel deserialization has to result in the same octree as the serial one.
+    const io::ByteStream expected = io::serialize_octree(io::deserialize_octree(stream), 0);
+    const io::ByteStream actual = io::serialize_octree(io::deserialize_octree(stream, thread_pool), 0);
+    if (!std::equal(expected.data().begin(), expected.data().end(), actual.data().begin(), actual.data().end())) {
+        state.SkipWithError("The parallel deserialization differs from the serial one.");
+        return;
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::deserialize_octree(stream, thread_pool));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * stream.size()));
+    state.counters["workers"] = static_cast<double>(thread_pool.worker_count());
+}
+
+namespace {
+
+/// Random indentations compress poorly, the architecture has large runs of equal cubes like a real map.
+std::shared_ptr<world::Cube> generate_compression_octree(const benchmark::State &state) {
+    const auto depth = static_cast<std::size_t>(state.range(1));
+    return state.range(0) == 0 ? tests::generate_octree(depth) : tests::generate_architecture(depth);
+}
+
+} // namespace
+
+/// Serialize into the compressed format version 2, the ratio is relative to version 0.
+void BM_SerializeCompressedOctree(benchmark::State &state) {
+    const std::shared_ptr<const world::Cube> cube = generate_compression_octree(state);
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        const io::ByteStream stream = io::serialize_octree(cube, 2);
+        bytes = stream.size();
+        benchmark::DoNotOptimize(stream);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+    state.counters["compression_ratio"] = static_cast<double>(io::serialize_octree(cube, 0).size()) / bytes;
+}
+
+/// Deserialize the compressed format version 2, the bytes are those of version 0 for comparison with
+/// BM_DeserializeOctree.
+void BM_DeserializeCompressedOctree(benchmark::State &state) {
+    const std::shared_ptr<const world::Cube> cube = generate_compression_octree(state);
+    const io::ByteStream stream = io::serialize_octree(cube, 2);
+    const std::size_t bytes = io::serialize_octree(cube, 0).size();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::deserialize_octree(stream));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+    state.counters["compression_ratio"] = static_cast<double>(bytes) / stream.size();
+}
+
+/// Decompress the records of version 0, without creating any cubes.
+void BM_DecompressOctreeRecords(benchmark::State &state) {
+    const io::ByteStream stream = io::serialize_octree(generate_compression_octree(state), 0);
+    const std::vector<std::uint8_t> compressed = io::compress(stream.data());
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::decompress(compressed, stream.size()));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * stream.size()));
+    state.counters["compression_ratio"] = static_cast<double>(stream.size()) / compressed.size();
+}
+
+/// Deserialize the deduplicated format version 3 into cubes, the ratio of the file size is relative to version 0.
+void BM_DeserializeDeduplicatedOctree(benchmark::State &state) {
+    const std::shared_ptr<const world::Cube> cube = generate_compression_octree(state);
+    const io::ByteStream stream = io::serialize_octree(cube, 3);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::deserialize_octree(stream));
+    }
+    state.counters["size_ratio"] = static_cast<double>(io::serialize_octree(cube, 0).size()) / stream.size();
+}
+
+/// Deserialize the deduplicated format version 3 into a snapshot, without creating any cubes.
+void BM_DeserializeOctreeSnapshot(benchmark::State &state) {
+    const std::shared_ptr<const world::Cube> cube = generate_compression_octree(state);
+    const io::ByteStream stream = io::serialize_octree(cube, 3);
+    std::size_t node_count = 0;
+    for (auto _ : state) {
+        const world::OctreeSnapshot snapshot = io::deserialize_octree_snapshot(stream);
+        node_count = snapshot.count_nodes();
+        benchmark::DoNotOptimize(snapshot);
+    }
+    std::size_t cube_count = 0;
+    world::visit_pre_order(*cube, [&cube_count](const world::Cube &) { cube_count++; });
+    state.counters["nodes"] = static_cast<double>(node_count);
+    state.counters["cubes"] = static_cast<double>(cube_count);
+}
+
+namespace {
+
+/// Write a serialized octree into a temporary file.
+std::filesystem::path write_octree_file(const std::size_t depth) {
+    const io::ByteStream stream = io::serialize_octree(tests::generate_octree(depth), 0);
+    const auto path = std::filesystem::temp_directory_path() / ("inexor_benchmark_" + std::to_string(depth) + ".nxoc");
+    std::ofstream file(path, std::ios::out | std::ios::binary);
+    file.write(reinterpret_cast<const char *>(stream.data().data()), static_cast<std::streamsize>(stream.size()));
+    return path;
+}
+
+} // namespace
+
+/// Serialize into memory first and write the whole stream into the file afterwards.
+void BM_SaveOctreeBuffered(benchmark::State &state) {
+    const std::shared_ptr<const world::Cube> cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+    const auto path = std::filesystem::temp_directory_path() / "inexor_benchmark_save.nxoc";
+    std::size_t allocated = 0;
+    for (auto _ : state) {
+        const std::size_t allocated_before = allocated_bytes();
+        const io::ByteStream stream = io::serialize_octree(cube, 0);
+        io::FileSink sink(path);
+        sink.write_bytes(stream.data());
+        sink.flush();
+        allocated = allocated_bytes() - allocated_before;
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * std::filesystem::file_size(path)));
+    state.counters["allocated_bytes"] = static_cast<double>(allocated);
+    std::filesystem::remove(path);
+}
+
+/// Stream into the file in blocks, while the next block is serialized.
+void BM_SaveOctreeStreamed(benchmark::State &state) {
+    const std::shared_ptr<const world::Cube> cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+    const auto path = std::filesystem::temp_directory_path() / "inexor_benchmark_save.nxoc";
+    std::size_t allocated = 0;
+    for (auto _ : state) {
+        const std::size_t allocated_before = allocated_bytes();
+        io::save_octree(cube, path, 0);
+        allocated = allocated_bytes() - allocated_before;
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * std::filesystem::file_size(path)));
+    state.counters["allocated_bytes"] = static_cast<double>(allocated);
+    std::filesystem::remove(path);
+}
+
+void BM_LoadOctreeFileMapped(benchmark::State &state) {
+    const auto path = write_octree_file(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::deserialize_octree(io::ByteStream(path)));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * std::filesystem::file_size(path)));
+    std::filesystem::remove(path);
+}
+
+void BM_LoadOctreeFileRead(benchmark::State &state) {
+    const auto path = write_octree_file(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(io::deserialize_octree(io::ByteStream::read_from_file(path)));
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * std::filesystem::file_size(path)));
+    std::filesystem::remove(path);
+}
+
+namespace {
+
+/// Bytes which are read in blocks by the reader benchmarks.
+constexpr std::size_t READ_BLOCK_SIZE = 4096;
+
+io::ByteStream make_byte_stream() {
+    std::vector<std::uint8_t> bytes(16 * 1024 * 1024);
+    std::iota(bytes.begin(), bytes.end(), std::uint8_t(0));
+    return io::ByteStream(std::move(bytes));
+}
+
+} // namespace
+
+/// Read every byte on its own, the end of the stream is checked on every read.
+void BM_ReadBytesChecked(benchmark::State &state) {
+    const io::ByteStream stream = make_byte_stream();
+    for (auto _ : state) {
+        io::ByteStreamReader reader(stream);
+        std::uint32_t sum = 0;
+        for (std::size_t idx = 0; idx < stream.size(); idx++) {
+            sum += reader.read<std::uint8_t>();
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * stream.size()));
+}
+
+/// Read every byte on its own, the end of the stream is checked once per block.
+void BM_ReadBytesUnchecked(benchmark::State &state) {
+    const io::ByteStream stream = make_byte_stream();
+    for (auto _ : state) {
+        io::ByteStreamReader reader(stream);
+        std::uint32_t sum = 0;
+        for (std::size_t block = 0; block < stream.size() / READ_BLOCK_SIZE; block++) {
+            reader.require(READ_BLOCK_SIZE);
+            for (std::size_t idx = 0; idx < READ_BLOCK_SIZE; idx++) {
+                sum += reader.read_byte_unchecked();
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * stream.size()));
+}
+
+/// Read blocks as spans, without copying them.
+void BM_ReadSpan(benchmark::State &state) {
+    const io::ByteStream stream = make_byte_stream();
+    for (auto _ : state) {
+        io::ByteStreamReader reader(stream);
+        std::uint32_t sum = 0;
+        for (std::size_t block = 0; block < stream.size() / READ_BLOCK_SIZE; block++) {
+            const auto bytes = reader.read_span(READ_BLOCK_SIZE);
+            sum = std::accumulate(bytes.begin(), bytes.end(), sum);
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * stream.size()));
+}
+
+void BM_IndentationPack(benchmark::State &state) {
+    std::array<world::Indentation, world::Cube::EDGES> indentations;
+    for (std::uint8_t edge_id = 0; edge_id < world::Cube::EDGES; edge_id++) {
+        indentations[edge_id] = world::Indentation(static_cast<std::uint8_t>(edge_id * 3));
+    }
+    for (auto _ : state) {
+        io::ByteStreamWriter writer;
+        for (std::size_t idx = 0; idx < 1000; idx++) {
+            writer.write(indentations);
+        }
+        benchmark::DoNotOptimize(writer.data().data());
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 1000));
+}
+
+void BM_IndentationUnpack(benchmark::State &state) {
+    std::array<world::Indentation, world::Cube::EDGES> indentations;
+    for (std::uint8_t edge_id = 0; edge_id < world::Cube::EDGES; edge_id++) {
+        indentations[edge_id] = world::Indentation(static_cast<std::uint8_t>(edge_id * 3));
+    }
+    io::ByteStreamWriter writer;
+    for (std::size_t idx = 0; idx < 1000; idx++) {
+        writer.write(indentations);
+    }
+    for (auto _ : state) {
+        io::ByteStreamReader reader(writer);
+        for (std::size_t idx = 0; idx < 1000; idx++) {
+            benchmark::DoNotOptimize(reader.read<std::array<world::Indentation, world::Cube::EDGES>>());
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * 1000));
+}
+
+BENCHMARK(BM_SerializeOctree)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeserializeOctree)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeserializeFlatOctree)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeserializeIndexedOctree)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadIndexedOctreeRegion)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeserializeOctreeParallel)
+    ->ArgsProduct({{0, 1}, {1, 2, 4, 8, 16}})
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
+BENCHMARK(BM_SerializeCompressedOctree)->ArgsProduct({{0, 1}, {5, 6}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeserializeCompressedOctree)->ArgsProduct({{0, 1}, {5, 6}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DecompressOctreeRecords)->ArgsProduct({{0, 1}, {5, 6}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeserializeDeduplicatedOctree)->ArgsProduct({{0, 1}, {5, 6}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeserializeOctreeSnapshot)->ArgsProduct({{0, 1}, {5, 6}})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SaveOctreeBuffered)->DenseRange(5, 7)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_SaveOctreeStreamed)->DenseRange(5, 7)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadOctreeFileMapped)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadOctreeFileRead)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReadBytesChecked)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReadBytesUnchecked)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReadSpan)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IndentationPack);
+BENCHMARK(BM_IndentationUnpack);
+
+} // namespace inexor::vulkan_renderer::benchmarks
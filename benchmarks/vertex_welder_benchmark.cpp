@@ -0,0 +1,122 @@
+#include "../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/octree_gpu_vertex.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/vertex_welder.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+namespace {
+
+constexpr std::size_t INPUT_VERTICES = 10'000'000;
+
+/// The vertices of the polygons of a generated octree with a single color, so shared corners are identical. The
+/// octree is repeated side by side until there are enough vertices, every copy adds its own unique vertices.
+const std::vector<OctreeGpuVertex> &input_vertices() {
+    static const std::vector<OctreeGpuVertex> vertices = [] {
+        const auto cube = tests::generate_octree(6);
+        std::vector<glm::vec3> positions;
+        for (const auto &polygons : cube->polygons(true)) {
+            for (const auto &polygon : polygons) {
+                positions.insert(positions.end(), polygon.begin(), polygon.end());
+            }
+        }
+        std::vector<OctreeGpuVertex> result;
+        result.reserve(INPUT_VERTICES);
+        for (std::size_t copy = 0; result.size() < INPUT_VERTICES; copy++) {
+            const glm::vec3 offset{static_cast<float>(copy) * 2048.0F, 0.0F, 0.0F};
+            for (std::size_t idx = 0; idx < positions.size() && result.size() < INPUT_VERTICES; idx++) {
+                result.emplace_back(positions[idx] + offset, glm::vec3{1.0F, 1.0F, 1.0F});
+            }
+        }
+        return result;
+    }();
+    return vertices;
+}
+
+/// The way the renderer merged vertices before the vertex welder.
+void weld_unordered_map(const std::vector<OctreeGpuVertex> &input, std::vector<OctreeGpuVertex> &vertices,
+                        std::vector<std::uint32_t> &indices) {
+    vertices.clear();
+    indices.clear();
+    std::unordered_map<OctreeGpuVertex, std::uint32_t> vertex_map;
+    for (const auto &vertex : input) {
+        if (vertex_map.count(vertex) == 0) {
+            vertex_map.emplace(vertex, static_cast<std::uint32_t>(vertex_map.size()));
+            vertices.push_back(vertex);
+        }
+        indices.push_back(vertex_map.at(vertex));
+    }
+}
+
+/// Check the result against the unordered_map, which merges the same vertices for this input.
+bool check_result(const std::vector<OctreeGpuVertex> &vertices, const std::vector<std::uint32_t> &indices) {
+    std::vector<OctreeGpuVertex> expected_vertices;
+    std::vector<std::uint32_t> expected_indices;
+    weld_unordered_map(input_vertices(), expected_vertices, expected_indices);
+    return vertices == expected_vertices && indices == expected_indices;
+}
+
+void set_counters(benchmark::State &state, const std::vector<OctreeGpuVertex> &vertices) {
+    state.counters["unique"] = static_cast<double>(vertices.size());
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * input_vertices().size()));
+}
+
+} // namespace
+
+void BM_WeldVerticesUnorderedMap(benchmark::State &state) {
+    const auto &input = input_vertices();
+    std::vector<OctreeGpuVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    for (auto _ : state) {
+        weld_unordered_map(input, vertices, indices);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    set_counters(state, vertices);
+}
+
+void BM_WeldVertices(benchmark::State &state) {
+    const auto &input = input_vertices();
+    VertexWelder welder;
+    std::vector<OctreeGpuVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    for (auto _ : state) {
+        welder.weld(input, vertices, indices);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    if (!check_result(vertices, indices)) {
+        state.SkipWithError("The welded vertices differ from the unordered_map.");
+        return;
+    }
+    set_counters(state, vertices);
+}
+
+void BM_WeldVerticesParallel(benchmark::State &state) {
+    const auto &input = input_vertices();
+    tools::ThreadPool thread_pool(static_cast<std::size_t>(state.range(0)));
+    VertexWelder welder;
+    std::vector<OctreeGpuVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    for (auto _ : state) {
+        welder.weld(input, vertices, indices, thread_pool);
+        benchmark::DoNotOptimize(indices.data());
+    }
+    if (!check_result(vertices, indices)) {
+        state.SkipWithError("The welded vertices differ from the unordered_map.");
+        return;
+    }
+    set_counters(state, vertices);
+    state.counters["workers"] = static_cast<double>(thread_pool.worker_count());
+}
+
+BENCHMARK(BM_WeldVerticesUnorderedMap)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_WeldVertices)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_WeldVerticesParallel)->RangeMultiplier(2)->Range(1, 16)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+} // namespace inexor::vulkan_renderer::benchmarks
@@ -0,0 +1,42 @@
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/chunk_streamer.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <thread>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+/// Stream in all chunks around the camera, every chunk is the same octree read from memory.
+void BM_ChunkStreamerLoadRadius(benchmark::State &state) {
+    const auto stream = io::serialize_octree(tests::generate_octree(static_cast<std::size_t>(state.range(0))));
+    tools::ThreadPool thread_pool;
+    world::ChunkStreamer::Settings settings;
+    settings.load_radius = 96.0F;
+    settings.max_pending_loads = thread_pool.worker_count() * 2;
+
+    std::size_t resident_chunks = 0;
+    world::ChunkStreamerMetrics metrics;
+    for (auto _ : state) {
+        world::ChunkStreamer streamer(
+            thread_pool, [&stream](const world::ChunkCoordinate &) { return std::make_optional(stream); }, settings);
+        // Stop as soon as no chunk is pending anymore, every chunk of the radius is resident then.
+        do {
+            streamer.update({0.0F, 0.0F, 0.0F});
+            std::this_thread::yield();
+        } while (streamer.metrics().pending_loads > 0);
+        resident_chunks = streamer.metrics().resident_chunks;
+        metrics = streamer.metrics();
+    }
+    state.counters["chunks"] = static_cast<double>(resident_chunks);
+    state.counters["avg_latency_us"] = static_cast<double>(metrics.average_load_latency().count());
+    state.counters["cpu_MiB"] = static_cast<double>(metrics.cpu_memory) / (1024 * 1024);
+}
+
+BENCHMARK(BM_ChunkStreamerLoadRadius)->DenseRange(2, 4)->Unit(benchmark::kMillisecond);
+
+} // namespace inexor::vulkan_renderer::benchmarks
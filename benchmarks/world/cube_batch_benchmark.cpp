@@ -0,0 +1,71 @@
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/cube_batch.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+struct NormalCube {
+    float size;
+    glm::vec3 position;
+    std::array<world::Indentation, world::Cube::EDGES> indentations;
+};
+
+/// Generate reproducible random Type::NORMAL cubes.
+[[nodiscard]] std::vector<NormalCube> generate_normal_cubes(const std::size_t count) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int> coordinate(0, 1023);
+    std::uniform_int_distribution<int> indentation_uid(0, 44);
+    std::vector<NormalCube> cubes(count);
+    for (auto &cube : cubes) {
+        cube.size = 4.0F;
+        cube.position = {static_cast<float>(coordinate(generator)), static_cast<float>(coordinate(generator)),
+                         static_cast<float>(coordinate(generator))};
+        for (auto &indentation : cube.indentations) {
+            indentation = world::Indentation(static_cast<std::uint8_t>(indentation_uid(generator)));
+        }
+    }
+    return cubes;
+}
+
+void BM_MakePolygonsPerCube(benchmark::State &state) {
+    const auto cubes = generate_normal_cubes(static_cast<std::size_t>(state.range(0)));
+    std::vector<world::Polygon> output(cubes.size() * world::Cube::POLYGONS);
+    for (auto _ : state) {
+        for (std::size_t idx = 0; idx < cubes.size(); idx++) {
+            const auto polygons =
+                world::Cube::make_polygons(world::Cube::Type::NORMAL, cubes[idx].size, cubes[idx].position,
+                                           cubes[idx].indentations);
+            std::copy(polygons.begin(), polygons.end(), output.begin() + idx * world::Cube::POLYGONS);
+        }
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_MakePolygonsBatched(benchmark::State &state) {
+    const auto cubes = generate_normal_cubes(static_cast<std::size_t>(state.range(0)));
+    world::NormalCubeBatch batch;
+    batch.reserve(cubes.size());
+    for (const auto &cube : cubes) {
+        batch.push_back(cube.size, cube.position, cube.indentations);
+    }
+    std::vector<world::Polygon> output(cubes.size() * world::Cube::POLYGONS);
+    for (auto _ : state) {
+        world::make_normal_polygons(batch, output);
+        benchmark::DoNotOptimize(output.data());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetLabel(world::normal_polygons_instruction_set());
+}
+
+BENCHMARK(BM_MakePolygonsPerCube)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_MakePolygonsBatched)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+} // namespace inexor::vulkan_renderer::benchmarks
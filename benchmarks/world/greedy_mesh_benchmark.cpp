@@ -0,0 +1,47 @@
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/greedy_mesh.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+void BM_CubeMesh(benchmark::State &state) {
+    const auto cube = tests::generate_architecture(static_cast<std::size_t>(state.range(0)));
+    auto invalidate = [](auto &self, const world::Cube &cube) -> void {
+        cube.invalidate_polygon_cache();
+        if (cube.type() == world::Cube::Type::OCTANT) {
+            for (const auto &child : cube.childs()) {
+                self(self, *child);
+            }
+        }
+    };
+    std::size_t polygons = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        invalidate(invalidate, *cube);
+        state.ResumeTiming();
+        polygons = 0;
+        for (const auto &cache : cube->polygons(true)) {
+            polygons += cache.size();
+        }
+    }
+    state.counters["polygons"] = static_cast<double>(polygons);
+}
+
+void BM_GreedyMesh(benchmark::State &state) {
+    const auto cube = tests::generate_architecture(static_cast<std::size_t>(state.range(0)));
+    std::size_t polygons = 0;
+    for (auto _ : state) {
+        const auto mesh = world::greedy_mesh(*cube);
+        polygons = mesh.size();
+        benchmark::DoNotOptimize(mesh);
+    }
+    state.counters["polygons"] = static_cast<double>(polygons);
+}
+
+BENCHMARK(BM_CubeMesh)->DenseRange(5, 7);
+BENCHMARK(BM_GreedyMesh)->DenseRange(5, 7);
+
+} // namespace inexor::vulkan_renderer::benchmarks
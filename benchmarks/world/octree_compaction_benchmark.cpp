@@ -0,0 +1,90 @@
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+namespace {
+
+/// Generate the architecture octree with all leaves subdivided down to the given depth, like after a long editing
+/// session. The shape is the same as the one of generate_architecture.
+std::shared_ptr<world::Cube> generate_expanded_architecture(const std::size_t depth) {
+    auto root = tests::generate_architecture(depth);
+    std::vector<world::Cube *> leaves;
+    world::visit_leaves(*root, [&leaves](world::Cube &cube) { leaves.push_back(&cube); });
+
+    auto expand = [depth](auto &self, world::Cube &cube) -> void {
+        if (cube.grid_level() == depth) {
+            return;
+        }
+        const world::Cube::Type type = cube.type();
+        cube.set_type(world::Cube::Type::OCTANT);
+        for (const auto &child : cube.childs()) {
+            child->set_type(type);
+            self(self, *child);
+        }
+    };
+    for (world::Cube *leaf : leaves) {
+        expand(expand, *leaf);
+    }
+    return root;
+}
+
+std::size_t count_cubes(const world::Cube &cube) {
+    std::size_t count = 0;
+    world::visit_pre_order(cube, [&count](const world::Cube &) { count++; });
+    return count;
+}
+
+} // namespace
+
+void BM_CubeCompact(benchmark::State &state) {
+    const auto depth = static_cast<std::size_t>(state.range(0));
+    std::size_t cubes_before = 0;
+    std::size_t cubes_after = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        auto cube = generate_expanded_architecture(depth);
+        cubes_before = count_cubes(*cube);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(cube->compact());
+        state.PauseTiming();
+        cubes_after = count_cubes(*cube);
+        cube.reset();
+        state.ResumeTiming();
+    }
+    state.counters["cubes_before"] = static_cast<double>(cubes_before);
+    state.counters["cubes_after"] = static_cast<double>(cubes_after);
+}
+
+void BM_CubePolygonsExpanded(benchmark::State &state) {
+    const auto cube = generate_expanded_architecture(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        state.PauseTiming();
+        world::visit_leaves(*cube, [](const world::Cube &cube) { cube.invalidate_polygon_cache(); });
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(cube->polygons(true));
+    }
+}
+
+void BM_CubePolygonsCompacted(benchmark::State &state) {
+    const auto cube = generate_expanded_architecture(static_cast<std::size_t>(state.range(0)));
+    cube->compact();
+    for (auto _ : state) {
+        state.PauseTiming();
+        world::visit_leaves(*cube, [](const world::Cube &cube) { cube.invalidate_polygon_cache(); });
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(cube->polygons(true));
+    }
+}
+
+BENCHMARK(BM_CubeCompact)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CubePolygonsExpanded)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CubePolygonsCompacted)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+
+} // namespace inexor::vulkan_renderer::benchmarks
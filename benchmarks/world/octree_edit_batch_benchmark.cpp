@@ -0,0 +1,79 @@
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_edit_batch.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+namespace {
+
+/// The brush stroke makes a leaf normal, indents two edges and finally makes it solid or empty.
+constexpr std::size_t EDITS_PER_LEAF = 4;
+
+/// Collect the first leaves of the octree, which are close to each other like the leaves touched by a brush stroke.
+std::vector<std::shared_ptr<world::Cube>> brush_leaves(world::Cube &root, const std::size_t count) {
+    std::vector<std::shared_ptr<world::Cube>> leaves;
+    world::visit_pre_order(root, [&](world::Cube &cube) {
+        if (cube.type() != world::Cube::Type::OCTANT || leaves.size() >= count) {
+            return;
+        }
+        for (const auto &child : cube.childs()) {
+            if (child->type() != world::Cube::Type::OCTANT && leaves.size() < count) {
+                leaves.push_back(child);
+            }
+        }
+    });
+    return leaves;
+}
+
+} // namespace
+
+void BM_CubeBrushStroke(benchmark::State &state) {
+    const auto cube = tests::generate_octree(7);
+    const auto leaves = brush_leaves(*cube, static_cast<std::size_t>(state.range(0)));
+    world::Cube::Type final_type = world::Cube::Type::SOLID;
+    for (auto _ : state) {
+        // Alternate the result, so every stroke changes all leaves.
+        final_type = final_type == world::Cube::Type::SOLID ? world::Cube::Type::EMPTY : world::Cube::Type::SOLID;
+        for (const auto &leaf : leaves) {
+            leaf->set_type(world::Cube::Type::NORMAL);
+            for (std::uint8_t edge_id = 0; edge_id < EDITS_PER_LEAF - 2; edge_id++) {
+                leaf->indent(edge_id, true, 1);
+            }
+            leaf->set_type(final_type);
+        }
+    }
+    state.counters["edits"] = static_cast<double>(leaves.size() * EDITS_PER_LEAF);
+    state.counters["leaves"] = static_cast<double>(leaves.size());
+}
+
+void BM_OctreeEditBatchBrushStroke(benchmark::State &state) {
+    const auto cube = tests::generate_octree(7);
+    const auto leaves = brush_leaves(*cube, static_cast<std::size_t>(state.range(0)));
+    world::OctreeEditBatch batch;
+    world::Cube::Type final_type = world::Cube::Type::SOLID;
+    for (auto _ : state) {
+        // Alternate the result, so every stroke changes all leaves.
+        final_type = final_type == world::Cube::Type::SOLID ? world::Cube::Type::EMPTY : world::Cube::Type::SOLID;
+        for (const auto &leaf : leaves) {
+            batch.set_type(leaf, world::Cube::Type::NORMAL);
+            for (std::uint8_t edge_id = 0; edge_id < EDITS_PER_LEAF - 2; edge_id++) {
+                batch.indent(leaf, edge_id, true, 1);
+            }
+            batch.set_type(leaf, final_type);
+        }
+        benchmark::DoNotOptimize(batch.commit());
+    }
+    state.counters["edits"] = static_cast<double>(leaves.size() * EDITS_PER_LEAF);
+    state.counters["leaves"] = static_cast<double>(leaves.size());
+}
+
+BENCHMARK(BM_CubeBrushStroke)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_OctreeEditBatchBrushStroke)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+} // namespace inexor::vulkan_renderer::benchmarks
@@ -0,0 +1,43 @@
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_lod.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+void BM_OctreeLodUnchanged(benchmark::State &state) {
+    const auto cube = tests::generate_architecture(static_cast<std::size_t>(state.range(0)));
+    world::OctreeLod lod;
+    lod.update(*cube, {100.0F, 300.0F, 100.0F});
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lod.update(*cube, {100.0F, 300.0F, 100.0F}));
+    }
+    state.counters["polygons"] = static_cast<double>(lod.polygons().size());
+}
+
+void BM_OctreeLodCameraMove(benchmark::State &state) {
+    const auto cube = tests::generate_architecture(static_cast<std::size_t>(state.range(0)));
+    world::OctreeLod lod;
+    bool moved = false;
+    for (auto _ : state) {
+        moved = !moved;
+        benchmark::DoNotOptimize(lod.update(*cube, moved ? glm::vec3{100.0F, 300.0F, 100.0F}
+                                                         : glm::vec3{900.0F, 300.0F, 900.0F}));
+    }
+    state.counters["polygons"] = static_cast<double>(lod.polygons().size());
+}
+
+void BM_CubePolygonsFullDetail(benchmark::State &state) {
+    const auto cube = tests::generate_architecture(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cube->polygons(true));
+    }
+}
+
+BENCHMARK(BM_OctreeLodUnchanged)->DenseRange(6, 8)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_OctreeLodCameraMove)->DenseRange(6, 8)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CubePolygonsFullDetail)->DenseRange(6, 8)->Unit(benchmark::kMillisecond);
+
+} // namespace inexor::vulkan_renderer::benchmarks
@@ -0,0 +1,68 @@
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+namespace {
+
+struct Ray {
+    glm::vec3 origin;
+    glm::vec3 direction;
+};
+
+/// Rays from inside the rooms of the architecture map into random directions, like the cursor ray of an editor.
+/// @param size The size of the octree, the rays start at half of its height.
+std::vector<Ray> generate_rays(const std::size_t count, const float size) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> position(0.0F, size);
+    std::uniform_real_distribution<float> direction(-1.0F, 1.0F);
+    std::vector<Ray> rays(count);
+    for (auto &ray : rays) {
+        ray.origin = {position(generator), size / 2, position(generator)};
+        ray.direction = {direction(generator), direction(generator), direction(generator)};
+    }
+    return rays;
+}
+
+} // namespace
+
+void BM_CubeRaycast(benchmark::State &state) {
+    const auto cube = tests::generate_architecture(static_cast<std::size_t>(state.range(0)));
+    const auto rays = generate_rays(1000, cube->size());
+    for (auto _ : state) {
+        for (const auto &ray : rays) {
+            benchmark::DoNotOptimize(cube->raycast(ray.origin, ray.direction));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rays.size()));
+}
+
+void BM_CubeRaycastRandomOctree(benchmark::State &state) {
+    const auto cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+    const auto rays = generate_rays(1000, cube->size());
+    for (auto _ : state) {
+        for (const auto &ray : rays) {
+            benchmark::DoNotOptimize(cube->raycast(ray.origin, ray.direction));
+        }
+    }
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations() * rays.size()));
+}
+
+void BM_CubeLeavesInBox(benchmark::State &state) {
+    const auto cube = tests::generate_architecture(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cube->leaves_in_box({200.0F, 0.0F, 200.0F}, {300.0F, 200.0F, 300.0F}));
+    }
+}
+
+BENCHMARK(BM_CubeRaycast)->DenseRange(6, 9)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CubeRaycastRandomOctree)->DenseRange(5, 7)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CubeLeavesInBox)->DenseRange(6, 9)->Unit(benchmark::kMicrosecond);
+
+} // namespace inexor::vulkan_renderer::benchmarks
@@ -0,0 +1,75 @@
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_dag.hpp"
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+namespace {
+
+/// Get the first leaf along the last childs, which is at the deepest level of the generated octrees.
+world::Cube &deepest_leaf(world::Cube &root) {
+    world::Cube *cube = &root;
+    while (cube->type() == world::Cube::Type::OCTANT) {
+        cube = cube->childs()[world::Cube::SUB_CUBES - 1].get();
+    }
+    return *cube;
+}
+
+} // namespace
+
+void BM_CubeCopy(benchmark::State &state) {
+    const auto cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+    world::Cube &leaf = deepest_leaf(*cube);
+    for (auto _ : state) {
+        leaf.set_type(leaf.type() == world::Cube::Type::EMPTY ? world::Cube::Type::SOLID : world::Cube::Type::EMPTY);
+        const auto copy = cube->clone();
+        benchmark::DoNotOptimize(copy);
+    }
+}
+
+void BM_CubeSnapshot(benchmark::State &state) {
+    const auto cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+    world::Cube &leaf = deepest_leaf(*cube);
+    benchmark::DoNotOptimize(cube->snapshot());
+    for (auto _ : state) {
+        leaf.set_type(leaf.type() == world::Cube::Type::EMPTY ? world::Cube::Type::SOLID : world::Cube::Type::EMPTY);
+        benchmark::DoNotOptimize(cube->snapshot());
+    }
+}
+
+void BM_CubeRestore(benchmark::State &state) {
+    const auto cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+    world::Cube &leaf = deepest_leaf(*cube);
+    const world::OctreeSnapshot before = cube->snapshot();
+    leaf.set_type(leaf.type() == world::Cube::Type::EMPTY ? world::Cube::Type::SOLID : world::Cube::Type::EMPTY);
+    const world::OctreeSnapshot after = cube->snapshot();
+    for (auto _ : state) {
+        cube->restore(before);
+        cube->restore(after);
+    }
+}
+
+/// Merge the identical subtrees of the architecture, which repeats the same walls in every room.
+void BM_OctreeDagDeduplicate(benchmark::State &state) {
+    const world::OctreeSnapshot snapshot =
+        tests::generate_architecture(static_cast<std::size_t>(state.range(0)))->snapshot();
+    std::size_t node_count = 0;
+    for (auto _ : state) {
+        world::OctreeDag dag;
+        benchmark::DoNotOptimize(dag.deduplicate(snapshot));
+        node_count = dag.node_count();
+    }
+    state.counters["nodes"] = static_cast<double>(snapshot.count_nodes());
+    state.counters["unique_nodes"] = static_cast<double>(node_count);
+}
+
+BENCHMARK(BM_CubeCopy)->DenseRange(4, 6)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CubeSnapshot)->DenseRange(4, 6)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_CubeRestore)->DenseRange(4, 6)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_OctreeDagDeduplicate)->DenseRange(5, 7)->Unit(benchmark::kMicrosecond);
+
+} // namespace inexor::vulkan_renderer::benchmarks
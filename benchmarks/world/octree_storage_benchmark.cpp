@@ -0,0 +1,114 @@
+#include "../allocation_counter.hpp"
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/flat_octree.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+void BM_CubeBuild(benchmark::State &state) {
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        const std::size_t allocations_before = allocation_count();
+        const std::size_t bytes_before = allocated_bytes();
+        auto cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+        allocations = allocation_count() - allocations_before;
+        bytes = allocated_bytes() - bytes_before;
+        benchmark::DoNotOptimize(cube);
+    }
+    state.counters["allocations"] = static_cast<double>(allocations);
+    state.counters["bytes"] = static_cast<double>(bytes);
+}
+
+void BM_FlatOctreeBuild(benchmark::State &state) {
+    const auto cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+    std::size_t allocations = 0;
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        const std::size_t allocations_before = allocation_count();
+        world::FlatOctree octree(*cube);
+        allocations = allocation_count() - allocations_before;
+        bytes = octree.memory_usage();
+        benchmark::DoNotOptimize(octree);
+    }
+    state.counters["allocations"] = static_cast<double>(allocations);
+    state.counters["bytes"] = static_cast<double>(bytes);
+}
+
+void BM_CubePolygons(benchmark::State &state) {
+    const auto cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+    auto invalidate = [](auto &self, const world::Cube &cube) -> void {
+        cube.invalidate_polygon_cache();
+        if (cube.type() == world::Cube::Type::OCTANT) {
+            for (const auto &child : cube.childs()) {
+                self(self, *child);
+            }
+        }
+    };
+    for (auto _ : state) {
+        state.PauseTiming();
+        invalidate(invalidate, *cube);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(cube->polygons(true));
+    }
+    state.counters["cubes"] = static_cast<double>(cube->count_geometry_cubes());
+}
+
+void BM_CubePolygonCacheRebuild(benchmark::State &state) {
+    // About one million geometry cubes.
+    const auto cube = tests::generate_octree(8);
+    auto invalidate = [](auto &self, const world::Cube &cube) -> void {
+        cube.invalidate_polygon_cache();
+        if (cube.type() == world::Cube::Type::OCTANT) {
+            for (const auto &child : cube.childs()) {
+                self(self, *child);
+            }
+        }
+    };
+    std::size_t allocations = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        invalidate(invalidate, *cube);
+        state.ResumeTiming();
+        const std::size_t allocations_before = allocation_count();
+        benchmark::DoNotOptimize(cube->polygons(true));
+        allocations = allocation_count() - allocations_before;
+    }
+    state.counters["allocations"] = static_cast<double>(allocations);
+    state.counters["cubes"] = static_cast<double>(cube->count_geometry_cubes());
+}
+
+void BM_CubeCountGeometryCubes(benchmark::State &state) {
+    const auto cube = tests::generate_octree(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cube->count_geometry_cubes());
+    }
+}
+
+void BM_FlatOctreePolygons(benchmark::State &state) {
+    const world::FlatOctree octree(*tests::generate_octree(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(octree.polygons());
+    }
+    state.counters["cubes"] = static_cast<double>(octree.count_geometry_cubes());
+}
+
+void BM_FlatOctreeCountGeometryCubes(benchmark::State &state) {
+    const world::FlatOctree octree(*tests::generate_octree(static_cast<std::size_t>(state.range(0))));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(octree.count_geometry_cubes());
+    }
+}
+
+BENCHMARK(BM_CubeBuild)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FlatOctreeBuild)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CubePolygons)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CubePolygonCacheRebuild)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FlatOctreePolygons)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CubeCountGeometryCubes)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_FlatOctreeCountGeometryCubes)->DenseRange(4, 6)->Unit(benchmark::kMillisecond);
+
+} // namespace inexor::vulkan_renderer::benchmarks
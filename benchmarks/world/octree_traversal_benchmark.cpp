@@ -0,0 +1,79 @@
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <functional>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+namespace {
+
+/// An octree which is only subdivided along one path, down to the given depth.
+std::shared_ptr<world::Cube> generate_deep_octree(const std::size_t depth) {
+    auto root = std::make_shared<world::Cube>(world::Cube::Type::SOLID, 1024.0F, glm::vec3{0.0F, 0.0F, 0.0F});
+    world::Cube *cube = root.get();
+    for (std::size_t level = 0; level < depth; level++) {
+        cube->set_type(world::Cube::Type::OCTANT);
+        cube = cube->childs()[world::Cube::SUB_CUBES - 1].get();
+    }
+    return root;
+}
+
+std::shared_ptr<world::Cube> generate_benchmark_octree(const std::int64_t depth) {
+    // Depths above 8 are only subdivided along one path, a random octree of this depth does not fit into memory.
+    return depth > 8 ? generate_deep_octree(static_cast<std::size_t>(depth))
+                     : tests::generate_octree(static_cast<std::size_t>(depth));
+}
+
+} // namespace
+
+void BM_StdFunctionTraversal(benchmark::State &state) {
+    const auto cube = generate_benchmark_octree(state.range(0));
+    for (auto _ : state) {
+        std::size_t geometry_cubes = 0;
+        std::function<void(const world::Cube &)> visit = [&](const world::Cube &cube) {
+            if (cube.type() == world::Cube::Type::OCTANT) {
+                for (const auto &child : cube.childs()) {
+                    visit(*child);
+                }
+                return;
+            }
+            if (cube.type() != world::Cube::Type::EMPTY) {
+                geometry_cubes++;
+            }
+        };
+        visit(*cube);
+        benchmark::DoNotOptimize(geometry_cubes);
+    }
+}
+
+void BM_IterativeTraversal(benchmark::State &state) {
+    const auto cube = generate_benchmark_octree(state.range(0));
+    for (auto _ : state) {
+        std::size_t geometry_cubes = 0;
+        world::visit_leaves(*cube, [&geometry_cubes](const world::Cube &cube) {
+            if (cube.type() != world::Cube::Type::EMPTY) {
+                geometry_cubes++;
+            }
+        });
+        benchmark::DoNotOptimize(geometry_cubes);
+    }
+}
+
+void BM_GridLevel(benchmark::State &state) {
+    const auto cube = generate_benchmark_octree(state.range(0));
+    for (auto _ : state) {
+        std::size_t grid_levels = 0;
+        world::visit_pre_order(*cube, [&grid_levels](const world::Cube &cube) { grid_levels += cube.grid_level(); });
+        benchmark::DoNotOptimize(grid_levels);
+    }
+}
+
+BENCHMARK(BM_StdFunctionTraversal)->DenseRange(4, 7)->Arg(64);
+BENCHMARK(BM_IterativeTraversal)->DenseRange(4, 7)->Arg(64);
+BENCHMARK(BM_GridLevel)->DenseRange(4, 7)->Arg(64);
+
+} // namespace inexor::vulkan_renderer::benchmarks
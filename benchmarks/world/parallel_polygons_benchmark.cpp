@@ -0,0 +1,32 @@
+#include "../../tests/world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace inexor::vulkan_renderer::benchmarks {
+
+void BM_CubePolygonsParallel(benchmark::State &state) {
+    const auto cube = tests::generate_octree(6);
+    tools::ThreadPool thread_pool(static_cast<std::size_t>(state.range(0)));
+    auto invalidate = [](auto &self, const world::Cube &cube) -> void {
+        cube.invalidate_polygon_cache();
+        if (cube.type() == world::Cube::Type::OCTANT) {
+            for (const auto &child : cube.childs()) {
+                self(self, *child);
+            }
+        }
+    };
+    for (auto _ : state) {
+        state.PauseTiming();
+        invalidate(invalidate, *cube);
+        state.ResumeTiming();
+        benchmark::DoNotOptimize(cube->polygons(thread_pool, true));
+    }
+    state.counters["workers"] = static_cast<double>(thread_pool.worker_count());
+}
+
+BENCHMARK(BM_CubePolygonsParallel)->RangeMultiplier(2)->Range(1, 16)->UseRealTime();
+
+} // namespace inexor::vulkan_renderer::benchmarks
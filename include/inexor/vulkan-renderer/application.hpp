@@ -1,14 +1,23 @@
 ﻿#pragma once
 
 #include "inexor/vulkan-renderer/input/keyboard_mouse_data.hpp"
+#include "inexor/vulkan-renderer/io/mesh_cache.hpp"
 #include "inexor/vulkan-renderer/renderer.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/chunk_streamer.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_lod.hpp"
+#include "inexor/vulkan-renderer/world/octree_mesh.hpp"
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
 
 #include <GLFW/glfw3.h>
 #include <vulkan/vulkan_core.h>
 
 #include <cstdint>
 #include <memory>
+#include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // forward declarations
@@ -33,6 +42,36 @@ class Application : public VulkanRenderer {
 
     std::unique_ptr<input::KeyboardMouseInputData> m_input_data;
 
+    /// Number of workers of the thread pool, ``0`` uses the number of hardware threads.
+    std::uint32_t m_thread_pool_workers{0};
+    std::unique_ptr<tools::ThreadPool> m_thread_pool;
+
+    std::shared_ptr<world::Cube> m_world;
+    world::OctreeMesh m_octree_mesh;
+    /// The octree mesh whose polygons are in the octree vertices, three vertices per polygon in the same order with one
+    /// index per vertex. Only the changed ranges of this mesh can be updated in place, nullptr if the octree vertices
+    /// contain anything else or have been merged.
+    const world::OctreeMesh *m_patchable_mesh{nullptr};
+    /// Merge coplanar faces of solid cubes instead of updating the octree mesh incrementally.
+    bool m_greedy_meshing{false};
+    /// Draw distant octants by a single representative cube instead of updating the octree mesh incrementally.
+    bool m_octree_lod_enabled{false};
+    world::OctreeLod m_octree_lod;
+    /// Directory of the chunk files of a streamed world, empty if the world is not streamed.
+    std::string m_chunk_directory;
+    world::ChunkStreamer::Settings m_chunk_streamer_settings;
+    /// Replaces the octree geometry with the chunks around the camera, empty if the world is not streamed.
+    std::unique_ptr<world::ChunkStreamer> m_chunk_streamer;
+    /// Mesh of the streamed chunks, every chunk is added and removed on its own.
+    world::OctreeMesh m_chunk_mesh;
+    /// The chunks in the chunk mesh, their roots are kept until they have been removed from it.
+    std::unordered_map<world::ChunkCoordinate, std::shared_ptr<world::Cube>, world::ChunkCoordinateHash> m_meshed_chunks;
+    /// Directory of the mesh cache, empty if octree meshes are not cached.
+    std::string m_mesh_cache_directory;
+    std::unique_ptr<io::MeshCache> m_mesh_cache;
+    /// The octree when its mesh has been loaded from the mesh cache, empty once the octree mesh has been generated.
+    std::optional<world::OctreeSnapshot> m_mesh_cache_snapshot;
+
     // If the user specified command line argument "--stop-on-validation-message", the program will call std::abort();
     // after reporting a validation layer (error) message.
     bool m_stop_on_validation_message = false;
@@ -43,7 +82,29 @@ class Application : public VulkanRenderer {
     void load_toml_configuration_file(const std::string &file_name);
     void load_textures();
     void load_shaders();
+    /// @brief Generate the octree vertices and indices, or load them from the mesh cache.
     void load_octree_geometry();
+    /// @brief Remesh the changed parts of the octree and upload only the changed vertices.
+    void update_octree_geometry();
+    /// @brief Add the loaded chunks to the chunk mesh and remove the evicted ones.
+    /// @return The changed ranges of the chunk mesh.
+    std::vector<world::OctreeMesh::PolygonRange> update_chunk_mesh();
+    /// @brief Upload the changed ranges of an octree mesh, or all of it if its layout has changed.
+    /// @param mesh The octree mesh.
+    /// @param changed_ranges The changed ranges of the octree mesh.
+    /// @param rebuild Upload the whole octree mesh, e.g. because the octree vertices contain another mesh.
+    void upload_octree_mesh(const world::OctreeMesh &mesh,
+                            const std::vector<world::OctreeMesh::PolygonRange> &changed_ranges, bool rebuild);
+    /// @brief Copy octree mesh polygons into the octree vertices, every vertex gets a random color.
+    /// @param mesh The octree mesh.
+    /// @param first_polygon The first octree mesh polygon to copy.
+    /// @param polygon_count The number of octree mesh polygons to copy.
+    void copy_octree_mesh_polygons(const world::OctreeMesh &mesh, std::size_t first_polygon,
+                                   std::size_t polygon_count);
+    /// @brief Replace the octree vertices with the greedy mesh of the octree, every vertex gets a random color.
+    void copy_greedy_mesh();
+    /// @brief Replace the octree vertices with polygons, every vertex gets a random color.
+    void copy_polygons(const std::vector<world::Polygon> &polygons);
     void setup_window_and_input_callbacks();
     void update_imgui_overlay();
     void check_application_specific_features();
@@ -434,6 +434,13 @@ public:
     /// @param target The resource to start the depth first search from
     void compile(const RenderResource &target);
 
+    /// @brief Overwrites a part of a buffer resource which has been uploaded during frame graph compilation
+    /// @param offset The offset in bytes from the start of the buffer
+    /// @param data A pointer to a contiguous block of memory that is at least `size` bytes long
+    /// @note The caller has to make sure that the buffer is not in use by the GPU!
+    /// @note The written range is flushed, as the memory of the buffer is not necessarily host coherent.
+    void update_buffer(const BufferResource &resource, std::size_t offset, const void *data, std::size_t size) const;
+
     /// @brief Submits the command frame's command buffers for drawing
     /// @param image_index The current frame, typically retrieved from vkAcquireNextImageKhr
     void render(int image_index, VkSemaphore signal_semaphore, VkSemaphore wait_semaphore,
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/tools/span.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+
+namespace inexor::vulkan_renderer::io {
+
+/// @brief Destination of the bytes flushed by a ByteStreamWriter.
+/// A writer calls the sink from a background thread, but never concurrently.
+class ByteSink {
+public:
+    ByteSink() = default;
+    ByteSink(const ByteSink &) = delete;
+    ByteSink(ByteSink &&) = delete;
+    virtual ~ByteSink() = default;
+
+    ByteSink &operator=(const ByteSink &) = delete;
+    ByteSink &operator=(ByteSink &&) = delete;
+
+    /// Append bytes, the span is only valid during the call.
+    /// @exception std::runtime_error The bytes could not be written.
+    virtual void write_bytes(tools::Span<const std::uint8_t> bytes) = 0;
+    /// Make sure all bytes have been handed over to their destination.
+    virtual void flush() {}
+};
+
+/// @brief Sink which writes into a file, the file is truncated if it exists.
+class FileSink : public ByteSink {
+private:
+    std::filesystem::path m_path;
+    std::ofstream m_file;
+
+public:
+    /// @exception std::runtime_error The file could not be opened.
+    explicit FileSink(std::filesystem::path path);
+
+    void write_bytes(tools::Span<const std::uint8_t> bytes) override;
+    void flush() override;
+};
+
+} // namespace inexor::vulkan_renderer::io
@@ -1,14 +1,27 @@
 #pragma once
 
+#include "inexor/vulkan-renderer/tools/span.hpp"
+
+#include <cassert>
 #include <cstdint>
 #include <filesystem>
+#include <future>
+#include <memory>
 #include <vector>
 
 namespace inexor::vulkan_renderer::io {
 
+// forward declaration
+class ByteSink;
+class MappedFile;
+
+/// Bytes which are either owned by the stream or memory mapped from a file.
+/// Copies of a memory mapped stream share the mapping.
 class ByteStream {
 protected:
     std::vector<std::uint8_t> m_buffer;
+    /// Used instead of the buffer if it is not empty.
+    std::shared_ptr<const MappedFile> m_mapping;
 
     /// Read from file.
     [[nodiscard]] static std::vector<std::uint8_t> read_file(const std::filesystem::path &path);
@@ -16,39 +29,124 @@ protected:
 public:
     ByteStream() = default;
     explicit ByteStream(std::vector<std::uint8_t> buffer);
-    /// Read from file.
+    /// Map a file into memory, it is read into a buffer if mapping is not possible.
     explicit ByteStream(const std::filesystem::path &path);
 
+    /// Read a whole file into a buffer, without memory mapping it.
+    [[nodiscard]] static ByteStream read_from_file(const std::filesystem::path &path);
+
     [[nodiscard]] std::size_t size() const;
-    [[nodiscard]] const std::vector<std::uint8_t> &buffer() const;
+    [[nodiscard]] tools::Span<const std::uint8_t> data() const;
+    /// Are the bytes memory mapped from a file.
+    [[nodiscard]] bool is_mapped() const noexcept;
 };
 
 class ByteStreamReader {
 private:
-    const ByteStream &m_stream;
-    /// Stream iterator.
-    std::vector<std::uint8_t>::const_iterator m_iter;
+    /// Current position in the stream.
+    const std::uint8_t *m_iter;
+    const std::uint8_t *m_end;
 
-    void check_end(std::size_t size) const;
+    [[noreturn]] static void throw_end_overrun();
+
+    void check_end(const std::size_t size) const {
+        if (static_cast<std::size_t>(m_end - m_iter) < size) {
+            throw_end_overrun();
+        }
+    }
 
 public:
     explicit ByteStreamReader(const ByteStream &stream);
+    /// Read only a part of the stream.
+    /// @exception std::runtime_error The part is not within the stream.
+    ByteStreamReader(const ByteStream &stream, std::size_t offset, std::size_t size);
 
     [[nodiscard]] std::size_t remaining() const;
     void skip(std::size_t size);
 
-    /// Generic read method.
+    /// Generic read method, which checks the end of the stream on every call.
     template <typename T, typename... Args>
     [[nodiscard]] T read(const Args &...);
+
+    /// Read bytes without copying them, the view is valid as long as the stream.
+    [[nodiscard]] tools::Span<const std::uint8_t> read_span(std::size_t size);
+
+    /// Check the end of the stream once for several reads, the next bytes can then be read by the unchecked methods.
+    /// @exception std::runtime_error The stream has less bytes left.
+    void require(const std::size_t size) const {
+        check_end(size);
+    }
+
+    /// Read a byte which has been required before.
+    [[nodiscard]] std::uint8_t read_byte_unchecked() noexcept {
+        assert(m_iter < m_end);
+        return *m_iter++;
+    }
+
+    /// Read a big endian std::uint32_t which has been required before.
+    [[nodiscard]] std::uint32_t read_uint32_unchecked() noexcept {
+        assert(m_end - m_iter >= 4);
+        const std::uint32_t value = (static_cast<std::uint32_t>(m_iter[0]) << 24U) |
+                                    (static_cast<std::uint32_t>(m_iter[1]) << 16U) |
+                                    (static_cast<std::uint32_t>(m_iter[2]) << 8U) | m_iter[3];
+        m_iter += 4;
+        return value;
+    }
+
+    /// Read bytes which have been required before, without copying them.
+    [[nodiscard]] tools::Span<const std::uint8_t> read_span_unchecked(const std::size_t size) noexcept {
+        assert(static_cast<std::size_t>(m_end - m_iter) >= size);
+        const tools::Span<const std::uint8_t> span(m_iter, size);
+        m_iter += size;
+        return span;
+    }
 };
 
+/// Writes into its own buffer, or streams into a sink in blocks of a fixed size.
 class ByteStreamWriter : public ByteStream {
+private:
+    ByteSink *m_sink{nullptr};
+    std::size_t m_block_size{0};
+    /// Block which is written into the sink in the background, while the next block is filled.
+    std::vector<std::uint8_t> m_flushing_block;
+    std::future<void> m_pending_flush;
+
+    /// Hand the buffer over to the sink if the block is full.
+    void flush_full_block() {
+        if (m_sink != nullptr && m_buffer.size() >= m_block_size) {
+            flush_block();
+        }
+    }
+    /// Wait until the previous block has been written, then write the buffer in the background.
+    void flush_block();
+    /// Wait until the previous block has been written.
+    /// @exception std::runtime_error The sink could not write the block.
+    void wait_for_flush();
+
 public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 1024 * 1024;
+
+    ByteStreamWriter() = default;
     using ByteStream::ByteStream;
+    /// Stream into a sink, at most two blocks are held in memory. The stream itself only holds the bytes which have
+    /// not been flushed yet. Writing into the sink overlaps with filling the next block.
+    /// \warning Call finish after the last write, otherwise the bytes of the last block are lost.
+    explicit ByteStreamWriter(ByteSink &sink, std::size_t block_size = DEFAULT_BLOCK_SIZE);
+    ByteStreamWriter(const ByteStreamWriter &) = delete;
+    ByteStreamWriter(ByteStreamWriter &&) = delete;
+    /// Waits for a block which is still being written.
+    ~ByteStreamWriter();
+
+    ByteStreamWriter &operator=(const ByteStreamWriter &) = delete;
+    ByteStreamWriter &operator=(ByteStreamWriter &&) = delete;
 
     /// Generic write method.
     template <typename T>
     void write(const T &value);
+
+    /// Write the remaining bytes into the sink and flush it, does nothing without a sink.
+    /// @exception std::runtime_error The sink could not write the bytes.
+    void finish();
 };
 
 } // namespace inexor::vulkan_renderer::io
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/tools/span.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace inexor::vulkan_renderer::io {
+
+/// Byte oriented LZ77 compression in the style of LZ4, which favours decompression speed over the compression ratio.
+/// The compressed bytes are a list of sequences: a token with the number of literals in the upper and the match length
+/// in the lower four bits, the literals, the offset of the match as little endian std::uint16_t and the rest of the
+/// match length. Lengths of 15 in the token are continued by bytes, 255 means another byte follows. The last sequence
+/// only has literals.
+[[nodiscard]] std::vector<std::uint8_t> compress(tools::Span<const std::uint8_t> bytes);
+
+/// Decompression of bytes which have been compressed by compress.
+/// @param size The size of the decompressed bytes.
+/// @exception std::runtime_error The bytes are corrupted or don't decompress into exactly size bytes.
+[[nodiscard]] std::vector<std::uint8_t> decompress(tools::Span<const std::uint8_t> bytes, std::size_t size);
+
+} // namespace inexor::vulkan_renderer::io
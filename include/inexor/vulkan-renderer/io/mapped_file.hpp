@@ -0,0 +1,38 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/tools/span.hpp"
+
+#include <cstdint>
+#include <filesystem>
+
+namespace inexor::vulkan_renderer::io {
+
+/// @brief Read-only memory mapping of a whole file.
+/// Pages are read from disk when they are accessed first, so mapping a file neither reads nor copies it up front.
+/// \warning The file must not be truncated while it is mapped, accessing the missing pages terminates the process.
+class MappedFile {
+private:
+    const std::uint8_t *m_data{nullptr};
+    std::size_t m_size{0};
+
+public:
+#if defined(__unix__) || defined(__APPLE__)
+    static constexpr bool SUPPORTED = true;
+#else
+    /// Only POSIX systems are supported so far.
+    static constexpr bool SUPPORTED = false;
+#endif
+
+    /// @exception std::runtime_error The file could not be opened or mapped, or mapping is not supported.
+    explicit MappedFile(const std::filesystem::path &path);
+    MappedFile(const MappedFile &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    ~MappedFile();
+
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+
+    [[nodiscard]] tools::Span<const std::uint8_t> data() const noexcept;
+};
+
+} // namespace inexor::vulkan_renderer::io
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/octree_gpu_vertex.hpp"
+#include "inexor/vulkan-renderer/tools/span.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace inexor::vulkan_renderer::io {
+
+/// On-disk cache of finished octree meshes, so loading a map doesn't have to generate its polygons and indices again.
+/// Every entry is a single file, a header followed by the vertices and the indices exactly as they are uploaded to the
+/// GPU. Loading an entry maps the file and copies both arrays, there is no parsing. The header stores the key of the
+/// octree the mesh belongs to. Entries of a changed octree, of another cache format or vertex layout, and truncated or
+/// corrupted entries are stale, they are not loaded and get replaced by the next store.
+/// \note The arrays are stored in the byte order of the machine, which is the one the GPU reads them in.
+class MeshCache {
+public:
+    struct Mesh {
+        std::vector<OctreeGpuVertex> vertices;
+        std::vector<std::uint32_t> indices;
+    };
+
+private:
+    std::filesystem::path m_directory;
+
+    [[nodiscard]] std::filesystem::path entry_path(const std::string &name) const;
+
+public:
+    /// Version of the mesh generation, which is part of every key. Increase it on every change of the generated
+    /// vertices or indices, e.g. of the polygons of a cube, so entries of an older renderer become stale.
+    static constexpr std::uint64_t MESHER_VERSION = 1;
+
+    /// @param directory The directory of the entries, it is created by the first store.
+    explicit MeshCache(std::filesystem::path directory);
+
+    /// Key of the mesh of an octree, a hash of the serialized octree and of MESHER_VERSION.
+    /// @param variant Distinguishes different meshes of the same octree, e.g. a greedy mesh.
+    [[nodiscard]] static std::uint64_t key(tools::Span<const std::uint8_t> serialized_octree, std::uint64_t variant = 0);
+
+    /// Load the mesh of an entry.
+    /// @param name The name of the entry, e.g. the name of the map. Every name has a single entry.
+    /// @return Nothing if there is no entry or if it is stale.
+    [[nodiscard]] std::optional<Mesh> load(const std::string &name, std::uint64_t key) const;
+    /// Replace an entry. It is written into a temporary file first, so a partially written entry is never loaded.
+    /// @exception std::runtime_error The entry could not be written.
+    void store(const std::string &name, std::uint64_t key, const std::vector<OctreeGpuVertex> &vertices,
+               const std::vector<std::uint32_t> &indices) const;
+};
+
+} // namespace inexor::vulkan_renderer::io
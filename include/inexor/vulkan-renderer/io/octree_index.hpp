@@ -0,0 +1,93 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// forward declaration
+namespace inexor::vulkan_renderer::world {
+class Cube;
+} // namespace inexor::vulkan_renderer::world
+
+// forward declaration
+namespace inexor::vulkan_renderer::tools {
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
+
+namespace inexor::vulkan_renderer::io {
+
+// forward declaration
+class ByteStream;
+class ByteStreamReader;
+
+/// Random access into a serialized octree.
+/// The levels above the index level are read when the index is created. The subtrees on the index level are read on
+/// demand, until then they are Type::EMPTY. Version 1 stores the offsets of the subtrees, for version 0 they are found
+/// by a prepass over the records, which skips the subtrees without creating their cubes.
+/// \warning The stream has to outlive the index.
+class OctreeIndex {
+private:
+    struct Subtree {
+        /// The cube which receives the subtree.
+        std::shared_ptr<world::Cube> cube;
+        /// Position of the records of the subtree in the stream.
+        std::size_t offset{0};
+        std::size_t size{0};
+        bool loaded{false};
+    };
+
+    const ByteStream &m_stream;
+    std::shared_ptr<world::Cube> m_root;
+    std::uint32_t m_index_level{0};
+    /// Subtrees in pre-order.
+    std::vector<Subtree> m_subtrees;
+
+    /// Read the levels above the index level and collect the cubes of the subtrees.
+    /// @param interleaved Version 0 has the records of every subtree between the records above the index level, they
+    /// are skipped and their position is stored.
+    void read_top_levels(ByteStreamReader &reader, bool interleaved);
+    /// Read the offsets which are stored by version 1.
+    void read_offsets(ByteStreamReader &reader);
+    /// Read the records of a subtree into the cube without invalidating anything, see deserialize_cube.
+    void read_subtree(std::size_t idx, world::Cube &cube) const;
+
+public:
+    /// Read the header, the levels above the index level and the offsets of the subtrees.
+    /// @param root The cube which receives the octree, it has to be owned by a shared pointer.
+    /// @param index_level The level of the subtrees for version 0, version 1 uses its stored level.
+    /// @exception std::runtime_error The stream is not an octree of a supported version.
+    OctreeIndex(const ByteStream &stream, std::shared_ptr<world::Cube> root, std::uint32_t index_level = DEFAULT_INDEX_LEVEL);
+
+    /// The octree, subtrees which have not been read yet are Type::EMPTY.
+    [[nodiscard]] const std::shared_ptr<world::Cube> &root() const noexcept;
+    [[nodiscard]] std::uint32_t index_level() const noexcept;
+    [[nodiscard]] std::size_t subtree_count() const noexcept;
+    /// The cube which receives the subtree, it has the size and position of the subtree.
+    [[nodiscard]] const std::shared_ptr<world::Cube> &subtree(std::size_t idx) const;
+    /// Size of the serialized subtree in bytes.
+    [[nodiscard]] std::size_t subtree_size(std::size_t idx) const;
+    [[nodiscard]] bool is_loaded(std::size_t idx) const;
+
+    /// Read a subtree into its cube, does nothing if it has been read already.
+    /// @exception std::runtime_error The subtree is corrupted.
+    void load_subtree(std::size_t idx);
+    /// Read a subtree into another cube, which has to be owned by a shared pointer. The subtree is not marked as read.
+    /// @exception std::runtime_error The subtree is corrupted.
+    void load_subtree_into(std::size_t idx, world::Cube &cube) const;
+    /// Read the subtrees on the thread pool. The octree is the same as if the subtrees had been read one after another.
+    /// @exception std::runtime_error A subtree is corrupted, the other subtrees are read nevertheless.
+    void load_subtrees(const std::vector<std::size_t> &indices, tools::ThreadPool &thread_pool);
+    /// Read all subtrees which overlap with the axis aligned box.
+    /// @return The number of subtrees which have been read by this call.
+    std::size_t load_region(const glm::vec3 &min, const glm::vec3 &max);
+    /// Read all subtrees which have not been read yet.
+    void load_all();
+    /// Read all subtrees which have not been read yet on the thread pool.
+    void load_all(tools::ThreadPool &thread_pool);
+};
+
+} // namespace inexor::vulkan_renderer::io
@@ -1,32 +1,94 @@
 #pragma once
 
+#include <glm/vec3.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
 #include <memory>
 #include <utility>
 
 // forward declaration
 namespace inexor::vulkan_renderer::world {
 class Cube;
+class FlatOctree;
+class OctreeSnapshot;
 } // namespace inexor::vulkan_renderer::world
 
+// forward declaration
+namespace inexor::vulkan_renderer::tools {
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
+
 // forward declaration
 namespace inexor::vulkan_renderer::io {
+class ByteSink;
 class ByteStream;
+class ByteStreamReader;
+class ByteStreamWriter;
 } // namespace inexor::vulkan_renderer::io
 
 namespace inexor::vulkan_renderer::io {
 
-constexpr std::uint32_t LATEST_OCTREE_FORMAT = 0;
+constexpr std::uint32_t LATEST_OCTREE_FORMAT = 1;
+/// Level 2 has up to 64 subtrees, enough to keep the workers of a thread pool busy.
+constexpr std::uint32_t DEFAULT_INDEX_LEVEL = 2;
+/// Version 3: memory budget of the cubes an octree may expand into. Nested references describe a number of cubes which
+/// is exponential in the size of the stream, so larger octrees are rejected before anything is expanded.
+constexpr std::size_t MAX_EXPANDED_OCTREE_MEMORY = std::size_t(256) << 20U;
+
+/// Settings of the octree formats, a version ignores the settings it doesn't use.
+struct OctreeFormatSettings {
+    /// Version 1: the subtrees on this level below the root can be read on their own, see OctreeIndex. Level n has at
+    /// most 8^n subtrees.
+    std::uint32_t index_level{DEFAULT_INDEX_LEVEL};
+};
 
 /// Serialization of an octree.
 [[nodiscard]] ByteStream serialize_octree(std::shared_ptr<const world::Cube> cube,
-                                          std::uint32_t version = LATEST_OCTREE_FORMAT);
+                                          std::uint32_t version = LATEST_OCTREE_FORMAT,
+                                          const OctreeFormatSettings &settings = {});
+/// Serialization of an octree into a sink, only a fixed amount of memory is used for buffering.
+void serialize_octree(std::shared_ptr<const world::Cube> cube, ByteSink &sink,
+                      std::uint32_t version = LATEST_OCTREE_FORMAT, const OctreeFormatSettings &settings = {});
+/// Serialization of an octree into a file, the file is truncated if it exists.
+void save_octree(std::shared_ptr<const world::Cube> cube, const std::filesystem::path &path,
+                 std::uint32_t version = LATEST_OCTREE_FORMAT, const OctreeFormatSettings &settings = {});
+/// Deserialization of an octree of any version.
+/// @exception std::runtime_error The cubes of an octree of version 3 exceed MAX_EXPANDED_OCTREE_MEMORY.
 [[nodiscard]] std::shared_ptr<world::Cube> deserialize_octree(const ByteStream &stream);
+/// Deserialization into a root cube of the given size and position, e.g. a chunk of a larger world.
+[[nodiscard]] std::shared_ptr<world::Cube> deserialize_octree(const ByteStream &stream, float size,
+                                                            const glm::vec3 &position);
+/// Deserialization of the subtrees on the default index level on the thread pool, see OctreeIndex. The octree is the
+/// same as the one of the serial deserialization. Versions 2 and 3 are deserialized serially.
+[[nodiscard]] std::shared_ptr<world::Cube> deserialize_octree(const ByteStream &stream, tools::ThreadPool &thread_pool);
+/// Deserialization into a snapshot in which identical subtrees share one node, see world::OctreeDag. Version 3 is read
+/// without creating any cubes, so repetitive maps take only a fraction of the memory of the cubes.
+/// @exception std::runtime_error The cubes of an octree of version 3 exceed MAX_EXPANDED_OCTREE_MEMORY.
+[[nodiscard]] world::OctreeSnapshot deserialize_octree_snapshot(const ByteStream &stream);
+/// Deserialization into a flat octree, see world::FlatOctree. The records of all versions are read into its node pools
+/// without creating any cubes.
+[[nodiscard]] world::FlatOctree deserialize_flat_octree(const ByteStream &stream);
+
+/// Check the identifier and read the version of the octree format.
+/// @exception std::runtime_error The stream does not start with the identifier.
+[[nodiscard]] std::uint32_t read_octree_header(ByteStreamReader &reader);
+/// Read the record of a single cube, its type followed by the indentations of a Type::NORMAL cube.
+/// \warning No caches are invalidated and no neighbours are marked as dirty, see deserialize_subtree.
+void deserialize_cube(ByteStreamReader &reader, world::Cube &cube);
+/// Read the records of a subtree in pre-order into the cube. The subtree and its neighbours are invalidated once after
+/// the records have been read, also if reading fails.
+void deserialize_subtree(ByteStreamReader &reader, world::Cube &cube);
 
 /// Specific version serialization.
 template <std::size_t version>
-[[nodiscard]] ByteStream serialize_octree_impl(std::shared_ptr<const world::Cube> cube);
+void serialize_octree_impl(std::shared_ptr<const world::Cube> cube, ByteStreamWriter &writer,
+                           const OctreeFormatSettings &settings);
 /// Specific version deserialization.
+/// @param root The cube which receives the octree, it has to be owned by a shared pointer.
 template <std::size_t version>
-[[nodiscard]] std::shared_ptr<world::Cube> deserialize_octree_impl(const ByteStream &stream);
+[[nodiscard]] std::shared_ptr<world::Cube> deserialize_octree_impl(const ByteStream &stream,
+                                                                 std::shared_ptr<world::Cube> root);
 
 } // namespace inexor::vulkan_renderer::io
@@ -8,6 +8,7 @@
 #include "inexor/vulkan-renderer/octree_gpu_vertex.hpp"
 #include "inexor/vulkan-renderer/settings_decision_maker.hpp"
 #include "inexor/vulkan-renderer/time_step.hpp"
+#include "inexor/vulkan-renderer/vertex_welder.hpp"
 #include "inexor/vulkan-renderer/vk_tools/gpu_info.hpp"
 #include "inexor/vulkan-renderer/wrapper/command_buffer.hpp"
 #include "inexor/vulkan-renderer/wrapper/command_pool.hpp"
@@ -78,10 +79,25 @@ protected:
     std::vector<wrapper::UniformBuffer> m_uniform_buffers;
     std::vector<wrapper::ResourceDescriptor> m_descriptors;
     std::vector<OctreeGpuVertex> m_octree_vertices;
-    std::vector<std::uint16_t> m_octree_indices;
+    std::vector<std::uint32_t> m_octree_indices;
+    VertexWelder m_vertex_welder;
+
+    /// The octree vertex buffer of the current frame graph.
+    BufferResource *m_octree_vertex_buffer{nullptr};
 
     void setup_frame_graph();
+    /// @brief Merge identical octree vertices and generate the indices of the remaining ones.
     void generate_octree_indices();
+    /// @brief Generate one index per octree vertex without merging any vertices, so every vertex keeps its position in
+    /// the vertex buffer and can be updated in place, see update_octree_vertices.
+    void generate_octree_identity_indices();
+    /// @brief Upload a range of the octree vertices again, without recompiling the frame graph.
+    /// @note The caller has to wait until the GPU doesn't use the vertex buffer anymore, once for all ranges.
+    /// @param first The index of the first vertex to upload.
+    /// @param count The number of vertices to upload.
+    void update_octree_vertices(std::size_t first, std::size_t count);
+    /// @brief Recompile the frame graph, e.g. after the size of the octree vertices has changed.
+    void recreate_frame_graph();
     void recreate_swapchain();
     void render_frame();
 
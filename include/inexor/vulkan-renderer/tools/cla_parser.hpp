@@ -51,6 +51,12 @@ class CommandLineArgumentParser {
         // Specifies which GPU to use (by array index).
         {"--gpu", true},
 
+        // Merges coplanar faces of solid cubes when meshing the octree.
+        {"--greedy-meshing", false},
+
+        // Always generates the octree mesh instead of loading it from the mesh cache.
+        {"--no-mesh-cache", false},
+
         // Disables the use of the special data transfer queue (forces use of the graphics queue).
         {"--no-separate-data-queue", false},
 
@@ -63,9 +69,15 @@ class CommandLineArgumentParser {
         // Disables vulkan debug markers (even if --renderdoc is specified).
         {"--no-vk-debug-markers", false},
 
+        // Draws distant octants by a single representative cube.
+        {"--octree-lod", false},
+
         // Enables the RenderDoc debug layer.
         {"--renderdoc", false},
 
+        // Specifies the number of worker threads of the job system.
+        {"--threads", true},
+
         // Enables vertical synchronisation (limits FPS to monitor refresh rate).
         {"--vsync", false},
 
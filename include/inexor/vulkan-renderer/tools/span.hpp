@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// @brief A non-owning view of contiguous elements, until the project can use C++20's std::span.
+template <typename T>
+class Span {
+    T *m_data{nullptr};
+    std::size_t m_size{0};
+
+public:
+    constexpr Span() noexcept = default;
+    constexpr Span(T *data, const std::size_t size) noexcept : m_data(data), m_size(size) {}
+    template <typename U>
+    constexpr Span(std::vector<U> &vector) noexcept : m_data(vector.data()), m_size(vector.size()) {}
+    template <typename U>
+    constexpr Span(const std::vector<U> &vector) noexcept : m_data(vector.data()), m_size(vector.size()) {}
+    template <typename U, std::size_t N>
+    constexpr Span(std::array<U, N> &array) noexcept : m_data(array.data()), m_size(N) {}
+    template <typename U, std::size_t N>
+    constexpr Span(const std::array<U, N> &array) noexcept : m_data(array.data()), m_size(N) {}
+
+    [[nodiscard]] constexpr T *data() const noexcept {
+        return m_data;
+    }
+
+    [[nodiscard]] constexpr std::size_t size() const noexcept {
+        return m_size;
+    }
+
+    [[nodiscard]] constexpr bool empty() const noexcept {
+        return m_size == 0;
+    }
+
+    [[nodiscard]] constexpr T *begin() const noexcept {
+        return m_data;
+    }
+
+    [[nodiscard]] constexpr T *end() const noexcept {
+        return m_data + m_size;
+    }
+
+    [[nodiscard]] constexpr T &operator[](const std::size_t idx) const {
+        assert(idx < m_size);
+        return m_data[idx];
+    }
+
+    /// @brief Get a view of ``count`` elements starting at ``offset``.
+    [[nodiscard]] constexpr Span subspan(const std::size_t offset, const std::size_t count) const {
+        assert(offset + count <= m_size);
+        return {m_data + offset, count};
+    }
+};
+
+} // namespace inexor::vulkan_renderer::tools
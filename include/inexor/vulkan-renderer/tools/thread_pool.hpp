@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+/// @brief A job system with a fixed number of worker threads.
+/// Every worker has its own queue of jobs. Workers take jobs from the back of their own queue and steal jobs from the
+/// front of the queues of other workers if their own queue is empty. Threads which wait for jobs help to execute them,
+/// so jobs can submit and wait for other jobs without blocking a worker.
+class ThreadPool {
+public:
+    using Job = std::function<void()>;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues;
+    std::vector<std::thread> m_workers;
+
+    /// Number of jobs which are queued but not taken yet.
+    std::atomic<std::size_t> m_queued_jobs{0};
+    /// Queue which receives the next job submitted from outside of the workers.
+    std::atomic<std::size_t> m_next_queue{0};
+    bool m_stop{false};
+    std::mutex m_sleep_mutex;
+    std::condition_variable m_wakeup;
+
+    /// Take a job from the queue of the given worker or steal one from the other workers.
+    [[nodiscard]] std::optional<Job> take_job(std::size_t queue_index);
+    void worker_loop(std::size_t worker_index);
+
+public:
+    /// @param worker_count The number of worker threads, ``0`` uses the number of hardware threads.
+    explicit ThreadPool(std::size_t worker_count = 0);
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool(ThreadPool &&) = delete;
+    /// @brief Finish all queued jobs and join the worker threads.
+    ~ThreadPool();
+
+    ThreadPool &operator=(const ThreadPool &) = delete;
+    ThreadPool &operator=(ThreadPool &&) = delete;
+
+    /// @brief Queue a job. Jobs submitted by a worker are queued at this worker.
+    /// \warning The job must not throw, use parallel_for for work which can fail.
+    void submit(Job job);
+
+    /// @brief Execute queued jobs on the calling thread until the counter reaches zero.
+    void wait(const std::atomic<std::size_t> &pending_jobs);
+
+    /// @brief Call ``function(index)`` for every index in ``[0, count)`` and wait until all calls are finished.
+    /// The calling thread helps to execute the jobs. If calls throw, the remaining calls are still executed and the
+    /// first exception is rethrown once all of them are finished.
+    template <typename Function>
+    void parallel_for(std::size_t count, const Function &function) {
+        std::atomic<std::size_t> pending_jobs{count};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+        const auto run = [&](const std::size_t index) {
+            try {
+                function(index);
+            } catch (...) {
+                std::lock_guard lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            pending_jobs.fetch_sub(1, std::memory_order_release);
+        };
+        for (std::size_t index = 0; index < count; index++) {
+            try {
+                submit([&run, index] { run(index); });
+            } catch (...) {
+                // The queued jobs refer to this stack frame, so they have to finish before it is left.
+                pending_jobs.fetch_sub(count - index, std::memory_order_release);
+                wait(pending_jobs);
+                throw;
+            }
+        }
+        wait(pending_jobs);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    [[nodiscard]] std::size_t worker_count() const noexcept {
+        return m_workers.size();
+    }
+};
+
+} // namespace inexor::vulkan_renderer::tools
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/octree_gpu_vertex.hpp"
+#include "inexor/vulkan-renderer/tools/span.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// forward declaration
+namespace inexor::vulkan_renderer::tools {
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
+
+namespace inexor::vulkan_renderer {
+
+/// Merges identical vertices of a triangle list into a list of unique vertices and an index per input vertex.
+/// Vertices are identical if all of their bytes are equal. The unique vertices are in the order of their first
+/// occurrence, so both variants of weld produce the same result.
+/// The serial variant looks up every vertex once in an open addressing hash table with linear probing, which is kept
+/// between calls. The parallel variant partitions the vertices by their hash first, like a pass of a radix sort, and
+/// welds every partition with a table of its own.
+/// Supported index types are std::uint16_t and std::uint32_t.
+class VertexWelder {
+private:
+    /// Index of a unique vertex plus one, zero marks an empty slot. The number of slots is a power of two.
+    std::vector<std::uint32_t> m_slots;
+
+    /// Clear the table and make sure it has enough slots for the given number of unique vertices.
+    void reset_slots(std::size_t unique_vertices);
+    /// Insert a unique vertex into the table, which must not contain it yet.
+    void insert_slot(const OctreeGpuVertex &vertex, std::uint32_t index) noexcept;
+
+public:
+    /// @param input The vertices of the triangle list.
+    /// @param vertices Receives the unique vertices, must not be the input.
+    /// @param indices Receives the index of the unique vertex of every input vertex.
+    /// @exception std::runtime_error There are more unique vertices than the index type can address.
+    template <typename Index>
+    void weld(tools::Span<const OctreeGpuVertex> input, std::vector<OctreeGpuVertex> &vertices,
+              std::vector<Index> &indices);
+    /// Partitioning variant of weld, which splits the vertices into blocks on the thread pool.
+    /// @param thread_pool The pool which runs the blocks, the call waits for all of them.
+    /// @exception std::runtime_error There are more unique vertices than the index type can address.
+    template <typename Index>
+    void weld(tools::Span<const OctreeGpuVertex> input, std::vector<OctreeGpuVertex> &vertices,
+              std::vector<Index> &indices, tools::ThreadPool &thread_pool);
+};
+
+} // namespace inexor::vulkan_renderer
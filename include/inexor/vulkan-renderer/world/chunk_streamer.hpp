@@ -0,0 +1,145 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// forward declaration
+namespace inexor::vulkan_renderer::tools {
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
+
+namespace inexor::vulkan_renderer::world {
+
+/// Integer coordinate of a chunk, the chunk starts at the coordinate multiplied by the chunk size.
+using ChunkCoordinate = glm::ivec3;
+
+struct ChunkCoordinateHash {
+    [[nodiscard]] std::size_t operator()(const ChunkCoordinate &coordinate) const noexcept;
+};
+
+/// Counters of a chunk streamer, memory sizes are in bytes.
+struct ChunkStreamerMetrics {
+    std::size_t resident_chunks{0};
+    std::size_t pending_loads{0};
+    /// Chunks which have been loaded since the streamer was created, including failed loads.
+    std::size_t loaded_chunks{0};
+    std::size_t failed_loads{0};
+    std::size_t evicted_chunks{0};
+    /// Estimated memory of the octrees of the resident chunks.
+    std::size_t cpu_memory{0};
+    /// Estimated vertex buffer memory of the meshes of the resident chunks.
+    std::size_t gpu_memory{0};
+    /// Time between requesting a chunk and it becoming resident.
+    std::chrono::microseconds last_load_latency{0};
+    std::chrono::microseconds max_load_latency{0};
+    std::chrono::microseconds total_load_latency{0};
+
+    [[nodiscard]] std::chrono::microseconds average_load_latency() const noexcept;
+};
+
+/// Splits the world into chunks of a fixed size, each one a separate octree, and keeps the chunks around the camera
+/// resident. Chunks are read, deserialized and meshed on the thread pool, so the frame which requests them is not
+/// blocked. Chunks outside of the load radius stay resident until one of the memory budgets is exceeded, then the
+/// ones furthest away from the camera are evicted first. No new chunks are requested while a budget is exceeded.
+/// \warning Every chunk is the root of its own octree, faces on the border of a chunk are never hidden by a neighbour.
+class ChunkStreamer {
+public:
+    /// Read the serialized octree of a chunk, std::nullopt if the chunk is empty space.
+    /// \warning It is called by the workers of the thread pool, so it has to be thread safe.
+    using ChunkLoader = std::function<std::optional<io::ByteStream>(const ChunkCoordinate &coordinate)>;
+
+    struct Settings {
+        float chunk_size{32.0F};
+        /// Chunks whose center is within this distance of the camera are loaded.
+        float load_radius{128.0F};
+        std::size_t cpu_memory_budget{512 * 1024 * 1024};
+        std::size_t gpu_memory_budget{256 * 1024 * 1024};
+        /// Size of one vertex in the vertex buffer, used to estimate the GPU memory of a chunk.
+        std::size_t vertex_size{sizeof(glm::vec3)};
+        /// Maximum number of chunks which are loaded at the same time.
+        std::size_t max_pending_loads{8};
+    };
+
+    struct Chunk {
+        /// Empty if the chunk is empty space or could not be loaded. Failed chunks are not requested again until they
+        /// have been dropped.
+        std::shared_ptr<Cube> root;
+        std::size_t cpu_memory{0};
+        std::size_t gpu_memory{0};
+    };
+
+private:
+    struct LoadResult {
+        ChunkCoordinate coordinate;
+        Chunk chunk;
+        /// Empty if the chunk has been loaded successfully.
+        std::string error;
+    };
+
+    /// Shared with the load jobs, so jobs which finish after the streamer has been destroyed don't access it.
+    struct LoadQueue {
+        ChunkLoader loader;
+        std::mutex mutex;
+        std::vector<LoadResult> finished;
+    };
+
+    tools::ThreadPool &m_thread_pool;
+    Settings m_settings;
+    std::shared_ptr<LoadQueue> m_load_queue;
+    std::unordered_map<ChunkCoordinate, Chunk, ChunkCoordinateHash> m_chunks;
+    /// Time at which the pending chunks have been requested.
+    std::unordered_map<ChunkCoordinate, std::chrono::steady_clock::time_point, ChunkCoordinateHash> m_pending_loads;
+    ChunkStreamerMetrics m_metrics;
+
+    /// Take over the chunks which have finished loading.
+    /// @return true if a chunk with geometry became resident.
+    bool collect_finished_loads();
+    /// Evict chunks outside of the load radius, furthest first, until both memory budgets are met.
+    /// Empty chunks outside of the load radius are dropped right away, as they cost nothing to request again.
+    /// @return true if a chunk with geometry has been evicted.
+    bool evict_chunks(const glm::vec3 &camera_position);
+    /// Request the missing chunks within the load radius, closest first.
+    void request_chunks(const glm::vec3 &camera_position);
+    /// Load a chunk on the calling thread, this is the job of a request.
+    [[nodiscard]] static LoadResult load_chunk(const ChunkLoader &loader, const ChunkCoordinate &coordinate,
+                                               const Settings &settings);
+    [[nodiscard]] bool is_over_budget() const noexcept;
+    /// Distance between the camera and the center of a chunk.
+    [[nodiscard]] float distance(const ChunkCoordinate &coordinate, const glm::vec3 &camera_position) const noexcept;
+
+public:
+    ChunkStreamer(tools::ThreadPool &thread_pool, ChunkLoader loader, const Settings &settings);
+    ChunkStreamer(const ChunkStreamer &) = delete;
+    ChunkStreamer(ChunkStreamer &&) = delete;
+    ~ChunkStreamer() = default;
+
+    ChunkStreamer &operator=(const ChunkStreamer &) = delete;
+    ChunkStreamer &operator=(ChunkStreamer &&) = delete;
+
+    /// Read every chunk from a file named ``<x>_<y>_<z>.nxoc`` in the directory, missing files are empty space.
+    [[nodiscard]] static ChunkLoader directory_loader(std::filesystem::path directory);
+
+    /// Take over loaded chunks, evict chunks if a budget is exceeded and request the missing chunks around the camera.
+    /// Call it once per frame, it never waits for a load to finish.
+    /// @return true if the polygons of the resident chunks have changed.
+    bool update(const glm::vec3 &camera_position);
+
+    [[nodiscard]] const std::unordered_map<ChunkCoordinate, Chunk, ChunkCoordinateHash> &chunks() const noexcept;
+    [[nodiscard]] const ChunkStreamerMetrics &metrics() const noexcept;
+    [[nodiscard]] const Settings &settings() const noexcept;
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -1,46 +1,81 @@
 #pragma once
 
+#include "inexor/vulkan-renderer/tools/span.hpp"
 #include "inexor/vulkan-renderer/world/indentation.hpp"
 
 #include <glm/vec3.hpp>
 
 #include <array>
 #include <cstdint>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <vector>
 
 // forward declaration
 namespace inexor::vulkan_renderer::world {
 class Cube;
+class OctreeEditBatch;
+class OctreeLod;
+class OctreeMesh;
+class OctreeSnapshot;
+struct SnapshotNode;
 } // namespace inexor::vulkan_renderer::world
 
 // forward declaration
-namespace inexor::vulkan_renderer::io {
-class ByteStream;
-template <std::size_t version>
-[[nodiscard]] std::shared_ptr<world::Cube> deserialize_octree_impl(const ByteStream &stream);
+namespace inexor::vulkan_renderer::tools {
+class ThreadPool;
+} // namespace inexor::vulkan_renderer::tools
 
+// forward declaration
+namespace inexor::vulkan_renderer::io {
+class ByteStreamReader;
+class OctreeIndex;
+void deserialize_cube(ByteStreamReader &reader, world::Cube &cube);
+void deserialize_subtree(ByteStreamReader &reader, world::Cube &cube);
 } // namespace inexor::vulkan_renderer::io
 
-void swap(inexor::vulkan_renderer::world::Cube &lhs, inexor::vulkan_renderer::world::Cube &rhs) noexcept;
+/// Swap the content of two cubes, both keep their parent and their grid level.
+void swap(inexor::vulkan_renderer::world::Cube &lhs, inexor::vulkan_renderer::world::Cube &rhs);
 
 namespace inexor::vulkan_renderer::world {
 
-/// std::vector<Polygon> can probably replaced with an array.
 using Polygon = std::array<glm::vec3, 3>;
 
-using PolygonCache = std::shared_ptr<std::vector<Polygon>>;
+/// View of the polygon cache of a geometry cube.
+/// \warning Only valid as long as the cube exists and its cache is not updated.
+using PolygonCache = tools::Span<const Polygon>;
+
+/// Geometry cube which has been hit by a ray, see Cube::raycast.
+struct RayHit {
+    std::shared_ptr<Cube> cube;
+    /// Distance from the ray origin in multiples of the ray direction.
+    float distance;
+    /// Face which has been hit, 0 = x, 1 = y, 2 = z.
+    std::size_t axis;
+    /// The face is on the positive side of the axis.
+    bool positive_direction;
+};
 
 class Cube : public std::enable_shared_from_this<Cube> {
-    friend void ::swap(Cube &lhs, Cube &rhs) noexcept;
-    template <std::size_t version>
-    friend std::shared_ptr<world::Cube> io::deserialize_octree_impl(const io::ByteStream &stream);
+    friend void ::swap(Cube &lhs, Cube &rhs);
+    friend OctreeEditBatch;
+    friend OctreeLod;
+    friend OctreeMesh;
+    friend io::OctreeIndex;
+    friend void io::deserialize_cube(io::ByteStreamReader &reader, Cube &cube);
+    friend void io::deserialize_subtree(io::ByteStreamReader &reader, Cube &cube);
+    friend std::vector<Polygon> greedy_mesh(const Cube &root);
 
 public:
     /// Maximum of sub cubes (childs)
     static constexpr std::size_t SUB_CUBES = 8;
     /// Cube edges.
     static constexpr std::size_t EDGES = 12;
+    /// Triangles of a geometry cube.
+    static constexpr std::size_t POLYGONS = 12;
+    /// Mesh slot of a cube which is not part of an octree mesh.
+    static constexpr std::uint32_t NO_MESH_SLOT = std::numeric_limits<std::uint32_t>::max();
     /// Cube Type.
     enum class Type { EMPTY = 0b00U, SOLID = 0b01U, NORMAL = 0b10U, OCTANT = 0b11U };
 
@@ -65,24 +100,92 @@ private:
 
     /// Root cube points to itself.
     std::weak_ptr<Cube> m_parent{weak_from_this()};
+    /// Root of the octree, empty for the root cube itself.
+    std::weak_ptr<Cube> m_root;
+    /// Depth of this cube in the octree, root cube = 0.
+    std::size_t m_grid_level{0};
 
     /// Indentations, should only be used if it is a geometry cube.
     std::array<Indentation, Cube::EDGES> m_indentations{};
     std::array<std::shared_ptr<Cube>, Cube::SUB_CUBES> m_childs{};
 
     /// Only geometry cube (Type::SOLID and Type::Normal) have a polygon cache.
-    mutable PolygonCache m_polygon_cache{nullptr};
+    /// The polygons are stored inline, as there are never more than Cube::POLYGONS.
+    mutable std::array<Polygon, Cube::POLYGONS> m_polygon_cache;
+    mutable std::uint8_t m_polygon_count{0};
     mutable bool m_polygon_cache_valid{false};
 
+    /// This cube or one of its descendants has been changed since the last remesh.
+    mutable bool m_dirty{true};
+    /// Slot of this cube in the octree mesh, the first face of its range.
+    mutable std::uint32_t m_mesh_slot{NO_MESH_SLOT};
+    /// Mesh slots of removed descendants, which have to be released on the next remesh.
+    mutable std::vector<std::uint32_t> m_released_mesh_slots;
+
+    /// Collapse uniform octants automatically on edits, only the setting of the root cube is used.
+    bool m_auto_compact{false};
+
+    /// Node of this cube in the last snapshot, empty if this cube or one of its descendants has been changed since.
+    /// If a cube has no snapshot node, none of its ancestors has one.
+    mutable std::shared_ptr<const SnapshotNode> m_snapshot;
+
     /// Removes all childs recursive.
     void remove_childs();
+    /// Set parent, root and grid level of all descendants, as this cube has been moved or got new childs.
+    void link_childs();
+    /// Hand over the mesh slots of this cube and all of its descendants, as they are going to be removed.
+    void release_mesh_slots(std::vector<std::uint32_t> &released_mesh_slots);
+    /// Invalidate the polygon cache and mark this cube and all of its ancestors as dirty.
+    void mark_dirty() const;
+    /// Invalidate the polygon caches and mark this cube, all of its descendants and all of its ancestors as dirty.
+    /// Also invalidates their snapshot nodes.
+    void mark_subtree_dirty();
+    /// Invalidate the snapshot nodes of this cube and all of its ancestors, as the content of this cube changed.
+    void invalidate_snapshot() const;
+    /// Replace this octant by a single leaf, if all of its childs are either Type::EMPTY or Type::SOLID.
+    /// @return true if the childs have been removed.
+    bool collapse();
+    /// Collapse the ancestors of this cube from the bottom up, as long as they are uniform.
+    void collapse_ancestors();
+    /// Set a new type, without collapsing the ancestors.
+    void change_type(Type new_type);
+    /// Fill the polygon cache with the polygons of this geometry cube, which are not hidden by neighbours.
+    /// @param polygons The Cube::POLYGONS polygons of this cube, as returned by make_polygons.
+    void update_polygon_cache(tools::Span<const Polygon> polygons) const;
+    /// Update all invalid polygon caches of this subtree. The polygons of Type::NORMAL cubes are generated in batches
+    /// by make_normal_polygons.
+    void update_polygon_caches() const;
+    /// Set a new type, without invalidating any caches or marking any cube as dirty.
+    void apply_type(Type new_type);
+    /// Is this cube still part of the octree of its root, it is not if an ancestor has been replaced by a leaf.
+    [[nodiscard]] bool is_attached() const noexcept;
 
     /// Get the root to this cube.
     [[nodiscard]] std::weak_ptr<Cube> root() const noexcept;
+    /// Get the root to this cube, which is the cube itself for the root. Unlike root, this is never empty if the
+    /// octree is owned by a shared pointer.
+    [[nodiscard]] std::weak_ptr<Cube> root_reference() noexcept;
+    /// Get the root to this cube, this cube itself if it is the root.
+    [[nodiscard]] const Cube &root_cube() const noexcept;
+    /// Get the cube which is adjacent to a face of this cube and has at least the same size.
+    /// @param axis 0 = x, 1 = y, 2 = z.
+    /// @param positive_direction Face in positive axis direction.
+    /// @return nullptr if the face is at the border of the octree.
+    [[nodiscard]] const Cube *neighbour(std::size_t axis, bool positive_direction) const;
+    /// Does the descendant touch the given face of this cube from the inside.
+    [[nodiscard]] bool touches_face(const Cube &cube, std::size_t axis, bool positive_direction) const noexcept;
+    /// Is the whole face of this cell covered by geometry, which is flat on the cell border.
+    [[nodiscard]] bool covers_face(std::size_t axis, bool positive_direction) const;
+    /// Mark all geometry cubes as dirty, which touch the given face of this cell from the inside.
+    void mark_face_dirty(std::size_t axis, bool positive_direction) const;
+    /// Mark all neighbours as dirty, as their hidden faces might have changed.
+    void mark_neighbours_dirty() const;
     /// Get the vertices of this cube. Use only on geometry cubes.
     [[nodiscard]] std::array<glm::vec3, 8> vertices() const noexcept;
+    /// Get the shared pointer which owns this cube, empty if there is none.
+    [[nodiscard]] std::shared_ptr<Cube> shared() const;
 
-    /// Optimized implementations of 90°, 180° and 270° rotations.
+    /// Optimized implementations of 90°, 180° and 270° rotations, which do not rotate the children.
     template <int Rotations>
     void rotate(const RotationAxis::Type &axis);
 
@@ -91,28 +194,69 @@ public:
     explicit Cube(Type type);
     Cube(Type type, float size, const glm::vec3 &position);
     Cube(std::weak_ptr<Cube> parent, Type type, float size, const glm::vec3 &position);
+    /// Deep copy, which is not linked to any octree. The copy is a root on grid level 0.
+    /// \warning The childs can't be linked to a copy which is not owned by a shared pointer yet, so the polygons of its
+    /// cubes can't be updated. Use clone, or assign the copy to a cube of an octree, which links it.
     Cube(const Cube &rhs);
-    Cube(Cube &&rhs) noexcept;
+    Cube(Cube &&rhs);
     ~Cube() = default;
+    /// Replace the content of this cube, it keeps its place in the octree.
     Cube &operator=(Cube rhs);
+    /// Deep copy as the root of a new octree, all of its cubes are linked to their parent and their root.
+    [[nodiscard]] std::shared_ptr<Cube> clone() const;
     /// Get child.
     std::shared_ptr<Cube> operator[](std::size_t idx);
     /// Get child.
     const std::shared_ptr<const Cube> operator[](std::size_t idx) const;
 
+    /// Get the vertices of a geometry cube described by its values, independent of any octree storage.
+    [[nodiscard]] static std::array<glm::vec3, 8>
+    make_vertices(Type type, float size, const glm::vec3 &position,
+                  const std::array<Indentation, EDGES> &indentations) noexcept;
+    /// Get the polygons of a geometry cube described by its values, independent of any octree storage.
+    [[nodiscard]] static std::array<Polygon, POLYGONS>
+    make_polygons(Type type, float size, const glm::vec3 &position,
+                  const std::array<Indentation, EDGES> &indentations) noexcept;
+
     /// Is the current cube root.
     [[nodiscard]] bool is_root() const noexcept;
     /// At which child level this cube is.
     /// root cube = 0
     [[nodiscard]] std::size_t grid_level() const noexcept;
     /// Count the number of Type::SOLID and Type::NORMAL cubes.
-    [[nodiscard]] std::size_t count_geometry_cubes() const noexcept;
+    [[nodiscard]] std::size_t count_geometry_cubes() const;
+    /// Has this cube or one of its descendants been changed since the last remesh.
+    [[nodiscard]] bool is_dirty() const noexcept;
+
+    /// Collapse all octants whose childs are all Type::EMPTY or all Type::SOLID into a single leaf, from the bottom up.
+    /// @return Number of removed cubes.
+    std::size_t compact();
+    /// Collapse uniform octants whenever a cube of this octree is set to Type::EMPTY or Type::SOLID.
+    /// Only the setting of the root cube is used.
+    /// \warning An edit can remove the edited cube and its siblings from the octree, don't iterate over the childs
+    /// of an octant while editing them.
+    void set_auto_compact(bool enabled) noexcept;
+    /// Are uniform octants collapsed automatically on edits.
+    [[nodiscard]] bool auto_compact() const noexcept;
+
+    /// Take an immutable snapshot of this subtree. Only the cubes which have been changed since the last snapshot are
+    /// copied, all other subtrees are shared with the previous snapshots.
+    [[nodiscard]] OctreeSnapshot snapshot() const;
+    /// Restore the content of a snapshot, e.g. to undo edits. Subtrees which are still shared with the snapshot are
+    /// skipped, so only the cubes which have been changed since are visited.
+    /// @param snapshot Needs the same size and position as this cube.
+    void restore(const OctreeSnapshot &snapshot);
 
     /// Set a new type.
     void set_type(Type new_type);
     /// Get type.
     [[nodiscard]] Type type() const noexcept;
 
+    /// Get size.
+    [[nodiscard]] float size() const noexcept;
+    /// Get position.
+    [[nodiscard]] glm::vec3 position() const noexcept;
+
     /// Get childs.
     [[nodiscard]] const std::array<std::shared_ptr<Cube>, Cube::SUB_CUBES> &childs() const;
     /// Get indentations.
@@ -129,14 +273,40 @@ public:
     /// @param rotations Value does not need to be adjusted beforehand. (e.g. mod 4)
     void rotate(const RotationAxis::Type &axis, int rotations);
 
-    /// TODO: in special cases some polygons have no surface, if completely surrounded by others
+    /// Faces which are completely covered by neighbouring cubes are not part of the cache.
     /// \warning Will update the cache even if it is considered as valid.
     void update_polygon_cache() const;
     /// Invalidate polygon cache.
     void invalidate_polygon_cache() const;
-    /// Recursive way to collect all the caches.
+    /// Get the polygon cache, empty if this is not a geometry cube.
+    [[nodiscard]] PolygonCache polygon_cache() const noexcept;
+    /// Is the face of this cube completely covered by its neighbours.
+    /// @param axis 0 = x, 1 = y, 2 = z.
+    /// @param positive_direction Face in positive axis direction.
+    [[nodiscard]] bool is_face_hidden(std::size_t axis, bool positive_direction) const;
+    /// Count the polygons of valid caches, which have been removed as they are hidden by neighbours.
+    [[nodiscard]] std::size_t count_hidden_polygons() const;
+    /// Recursive way to collect the caches of all geometry cubes.
     /// @param update_invalid If true it will update invalid polygon caches.
     [[nodiscard]] std::vector<PolygonCache> polygons(bool update_invalid = false) const;
+    /// Find the first geometry cube hit by a ray.
+    /// The octree is traversed front to back, so the traversal stops at the first hit and skips everything behind it.
+    /// @param direction Does not need to be normalized.
+    /// @param max_distance Hits further away in multiples of the direction are ignored.
+    /// @return Empty if nothing has been hit. The root cube is only returned if it is owned by a shared pointer.
+    [[nodiscard]] std::optional<RayHit> raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+                                                float max_distance = std::numeric_limits<float>::infinity()) const;
+    /// Get the leaf which contains the point, nullptr if the point is outside of this cube.
+    /// Points on the border between two leaves belong to the one in positive axis direction.
+    [[nodiscard]] std::shared_ptr<Cube> leaf_at(const glm::vec3 &point) const;
+    /// Collect all leaves, including Type::EMPTY, which overlap with the box, in pre-order.
+    /// Leaves which only touch the border of the box are left out.
+    [[nodiscard]] std::vector<std::shared_ptr<Cube>> leaves_in_box(const glm::vec3 &min, const glm::vec3 &max) const;
+
+    /// Collect all the caches in parallel, the result is in the same order as the serial version.
+    /// The octree is split into subtrees, which are collected by the workers of the thread pool.
+    /// @param update_invalid If true it will update invalid polygon caches.
+    [[nodiscard]] std::vector<PolygonCache> polygons(tools::ThreadPool &thread_pool, bool update_invalid = false) const;
 };
 
 } // namespace inexor::vulkan_renderer::world
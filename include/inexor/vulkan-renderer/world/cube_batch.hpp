@@ -0,0 +1,45 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/tools/span.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Type::NORMAL cubes stored as structure of arrays, the input of the batched polygon generation.
+class NormalCubeBatch {
+    friend void make_normal_polygons(const NormalCubeBatch &batch, tools::Span<Polygon> output);
+
+private:
+    std::vector<float> m_positions_x;
+    std::vector<float> m_positions_y;
+    std::vector<float> m_positions_z;
+    std::vector<float> m_sizes;
+    /// Per edge: indent of start in the lower and indent of end in the upper four bits.
+    std::array<std::vector<std::uint8_t>, Cube::EDGES> m_indentations;
+
+public:
+    void reserve(std::size_t count);
+    void clear() noexcept;
+    void push_back(float size, const glm::vec3 &position, const std::array<Indentation, Cube::EDGES> &indentations);
+
+    /// Number of cubes.
+    [[nodiscard]] std::size_t size() const noexcept;
+};
+
+/// Generate the polygons of all cubes of the batch, with the same result as Cube::make_polygons.
+/// Several cubes are processed at once with AVX2 or SSE2, depending on the instruction sets enabled at compile time.
+/// @param output Receives Cube::POLYGONS polygons per cube, in the order of the batch.
+/// @throw std::invalid_argument The output is too small.
+void make_normal_polygons(const NormalCubeBatch &batch, tools::Span<Polygon> output);
+
+/// Name of the instruction set used by make_normal_polygons.
+[[nodiscard]] const char *normal_polygons_instruction_set() noexcept;
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Index of a node inside the node pool of a FlatOctree.
+using NodeHandle = std::uint32_t;
+
+/// Octree storage engine which keeps all nodes in contiguous pools instead of one heap allocation per cube.
+/// The eight children of an octant are always allocated as one block, so a child is reached by adding its index to the
+/// handle of the first child. Nodes do not store their size or position, both are derived while traversing.
+class FlatOctree {
+public:
+    /// Handle which does not refer to any node.
+    static constexpr NodeHandle INVALID_HANDLE = std::numeric_limits<NodeHandle>::max();
+    /// The root node is always the first node of the pool.
+    static constexpr NodeHandle ROOT = 0;
+
+    struct Node {
+        Cube::Type type{Cube::Type::SOLID};
+        /// Type::OCTANT: handle of the first child of the block of eight.
+        /// Type::NORMAL: index into the indentation pool.
+        std::uint32_t payload{INVALID_HANDLE};
+    };
+
+private:
+    float m_size{32};
+    glm::vec3 m_position{0.0F, 0.0F, 0.0F};
+
+    std::vector<Node> m_nodes;
+    std::vector<std::array<Indentation, Cube::EDGES>> m_indentations;
+
+    /// First handles of released blocks of eight nodes.
+    std::vector<NodeHandle> m_free_blocks;
+    /// Released slots of the indentation pool.
+    std::vector<std::uint32_t> m_free_indentations;
+
+    /// Get a block of eight Type::SOLID nodes and return the handle of the first one.
+    [[nodiscard]] NodeHandle allocate_block();
+    /// Release a block of eight nodes including all of their descendants.
+    void release_block(NodeHandle first_child);
+    /// Get a slot in the indentation pool.
+    [[nodiscard]] std::uint32_t allocate_indentations();
+
+    /// Copy the subtree of the cube into the node.
+    void import_cube(NodeHandle node, const Cube &cube);
+    /// Copy the subtree of the node into the cube.
+    void export_cube(NodeHandle node, Cube &cube) const;
+
+public:
+    explicit FlatOctree(Cube::Type type = Cube::Type::SOLID, float size = 32,
+                        const glm::vec3 &position = {0.0F, 0.0F, 0.0F});
+    /// Convert a pointer based octree.
+    explicit FlatOctree(const Cube &cube);
+
+    /// Convert into a pointer based octree.
+    [[nodiscard]] std::shared_ptr<Cube> to_cube() const;
+
+    /// Size of the root cube.
+    [[nodiscard]] float size() const noexcept;
+    /// Position of the root cube.
+    [[nodiscard]] glm::vec3 position() const noexcept;
+
+    /// Get the node behind a handle.
+    [[nodiscard]] const Node &node(NodeHandle handle) const;
+    /// Get the handle of a child. Use only on octants.
+    [[nodiscard]] NodeHandle child(NodeHandle handle, std::size_t idx) const;
+    /// Get the type of a node.
+    [[nodiscard]] Cube::Type type(NodeHandle handle) const;
+    /// Set a new type of a node, octants will get eight Type::SOLID children.
+    void set_type(NodeHandle handle, Cube::Type new_type);
+    /// Get the indentations of a node. Use only on Type::NORMAL nodes.
+    [[nodiscard]] const std::array<Indentation, Cube::EDGES> &indentations(NodeHandle handle) const;
+    /// Set an indent by the edge id. Ignored if the node is not Type::NORMAL.
+    void set_indent(NodeHandle handle, std::uint8_t edge_id, Indentation indentation);
+    /// Set all indentations of a node. Ignored if the node is not Type::NORMAL.
+    void set_indentations(NodeHandle handle, const std::array<Indentation, Cube::EDGES> &indentations);
+
+    /// Number of nodes which are in use.
+    [[nodiscard]] std::size_t node_count() const noexcept;
+    /// Count the number of Type::SOLID and Type::NORMAL cubes.
+    [[nodiscard]] std::size_t count_geometry_cubes() const;
+    /// Bytes reserved by the pools.
+    [[nodiscard]] std::size_t memory_usage() const noexcept;
+
+    /// Collect the polygons of all geometry cubes in the same order as Cube::polygons, but without hidden face removal.
+    [[nodiscard]] std::vector<Polygon> polygons() const;
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,14 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Collect the polygons of an octree, where the visible faces of Type::SOLID cubes are merged.
+/// Coplanar faces with the same orientation are merged into maximal rectangles, even across octree levels. Every
+/// rectangle results in two polygons, Type::NORMAL cubes keep their polygons. Hidden faces are removed.
+[[nodiscard]] std::vector<Polygon> greedy_mesh(const Cube &root);
+
+} // namespace inexor::vulkan_renderer::world
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
 
 namespace inexor::vulkan_renderer::world {
@@ -7,6 +8,10 @@ namespace inexor::vulkan_renderer::world {
 class Indentation {
 public:
     static constexpr std::uint8_t MAX = 8;
+    /// Number of different indentations, valid uids are below.
+    static constexpr std::uint8_t UID_COUNT = 45;
+    /// Bytes of the packed uids of the twelve edges of a cube, six bits each.
+    static constexpr std::size_t PACKED_EDGES_SIZE = 9;
 
 private:
     std::uint8_t m_start{0};
@@ -43,6 +48,13 @@ public:
     void mirror() noexcept;
 
     [[nodiscard]] std::uint8_t uid() const;
+
+    /// Pack the uids of all edges of a cube, the first edge is in the upper bits of the first byte.
+    [[nodiscard]] static std::array<std::uint8_t, PACKED_EDGES_SIZE>
+    pack(const std::array<Indentation, 12> &indentations) noexcept;
+    /// Unpack the indentations of all edges of a cube, invalid uids result in default indentations.
+    [[nodiscard]] static std::array<Indentation, 12>
+    unpack(const std::array<std::uint8_t, PACKED_EDGES_SIZE> &bytes) noexcept;
 };
 
 } // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Hash-consing of snapshot nodes, which turns octrees into directed acyclic graphs: identical subtrees are merged into
+/// one shared node. Repetitive maps like tiled floors, walls or rows of pillars keep only one node per distinct subtree.
+/// Snapshot nodes don't store their size or position, so every instance of a shared subtree is still positioned
+/// correctly by OctreeSnapshot::polygons and OctreeSnapshot::to_cube.
+/// \warning The DAG keeps all of its nodes alive until it is destroyed.
+class OctreeDag {
+private:
+    struct NodeHash {
+        std::size_t operator()(const SnapshotNode *node) const noexcept;
+    };
+    /// Children are compared by their address, as they are unique nodes of the DAG already.
+    struct NodeEqual {
+        bool operator()(const SnapshotNode *lhs, const SnapshotNode *rhs) const noexcept;
+    };
+
+    /// The unique nodes, keyed by the address of the node itself.
+    std::unordered_map<const SnapshotNode *, std::shared_ptr<const SnapshotNode>, NodeHash, NodeEqual> m_nodes;
+
+public:
+    /// Get the unique node with the same content, it is added if there is none yet.
+    /// @param node The childs of an octant have to be unique nodes of this DAG.
+    [[nodiscard]] std::shared_ptr<const SnapshotNode> intern(SnapshotNode node);
+    /// Merge the identical subtrees of a snapshot. Nodes which are shared by the snapshot already are merged only once.
+    [[nodiscard]] OctreeSnapshot deduplicate(const OctreeSnapshot &snapshot);
+
+    /// Number of unique nodes.
+    [[nodiscard]] std::size_t node_count() const noexcept;
+};
+
+} // namespace inexor::vulkan_renderer::world
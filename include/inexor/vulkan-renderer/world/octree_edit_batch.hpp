@@ -0,0 +1,55 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Collects edits of many cubes and applies them at once.
+/// Several edits of the same cube are merged into one. On commit, every changed cube and its neighbours are marked as
+/// dirty once, instead of once per edit, and a following OctreeMesh::update remeshes all of them in one pass.
+/// \warning Don't edit the cubes directly while they have pending edits in a batch.
+class OctreeEditBatch {
+private:
+    /// State of a cube after all of its pending edits.
+    struct Edit {
+        std::shared_ptr<Cube> cube;
+        Cube::Type type;
+        std::array<Indentation, Cube::EDGES> indentations;
+    };
+
+    std::vector<Edit> m_edits;
+    /// Index of the pending edit of a cube.
+    std::unordered_map<const Cube *, std::size_t> m_edit_indices;
+
+    /// Get the pending edit of the cube, a new one is started from the current state of the cube.
+    [[nodiscard]] Edit &edit(const std::shared_ptr<Cube> &cube);
+
+public:
+    /// Set a new type, like Cube::set_type.
+    /// The childs of a new octant can only be edited by another batch, as they don't exist before the commit.
+    void set_type(const std::shared_ptr<Cube> &cube, Cube::Type new_type);
+    /// Set an indent by the edge id, like Cube::set_indent. Ignored if the cube won't be Type::NORMAL.
+    void set_indent(const std::shared_ptr<Cube> &cube, std::uint8_t edge_id, Indentation indentation);
+    /// Indent a specific edge by steps, like Cube::indent. Ignored if the cube won't be Type::NORMAL.
+    /// @param positive_direction Indent in  positive axis direction.
+    void indent(const std::shared_ptr<Cube> &cube, std::uint8_t edge_id, bool positive_direction, std::uint8_t steps);
+
+    /// Number of cubes with pending edits.
+    [[nodiscard]] std::size_t size() const noexcept;
+    /// Has the batch no pending edits.
+    [[nodiscard]] bool empty() const noexcept;
+
+    /// Apply all pending edits and mark the changed cubes and their neighbours as dirty. The batch is empty afterwards.
+    /// @return The changed cubes, in the order of their first edit. Cubes whose edits did not change anything or which
+    /// have been removed from the octree by the edit of an ancestor are left out.
+    std::vector<std::shared_ptr<Cube>> commit();
+};
+
+} // namespace inexor::vulkan_renderer::world
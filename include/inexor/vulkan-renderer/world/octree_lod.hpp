@@ -0,0 +1,66 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Polygons of an octree, where distant octants are replaced by a single representative cube.
+/// An octant is drawn as one Type::SOLID cube if at least half of its volume is solid, otherwise it is left out. The
+/// selection and the polygons are only rebuilt if the camera moved far enough to change the selection, or if the octree
+/// has been changed. Representatives are cached as long as their octant is unchanged.
+class OctreeLod {
+public:
+    /// Selected cube, either a leaf in full detail or an octant drawn by its representative.
+    struct Selection {
+        const Cube *cube;
+        /// Node of the cube in the snapshot of the update, changes on every edit of the subtree.
+        const SnapshotNode *node;
+        bool representative;
+
+        bool operator==(const Selection &rhs) const noexcept {
+            return cube == rhs.cube && node == rhs.node && representative == rhs.representative;
+        }
+    };
+
+private:
+    float m_detail_factor;
+    std::vector<Selection> m_selection;
+    std::vector<Polygon> m_polygons;
+    /// Keeps the nodes of the selection alive, so their addresses are not reused by new nodes.
+    std::optional<OctreeSnapshot> m_snapshot;
+    /// Solid volume fraction of the octants of the selection.
+    std::unordered_map<const SnapshotNode *, float> m_solid_fractions;
+
+    /// Get the solid volume fraction of a subtree, Type::NORMAL cubes count as solid.
+    [[nodiscard]] float solid_fraction(const SnapshotNode &node,
+                                       std::unordered_map<const SnapshotNode *, float> &previous_fractions);
+    /// Is a face of a leaf in full detail adjacent to an octant which is left out. The neighbours of the face hide it
+    /// only if they are drawn, which they are not inside of a left out octant.
+    /// @param drawn Octants of the selection which are drawn by their representative, mapped to whether it is drawn.
+    [[nodiscard]] static bool borders_left_out_octant(const Cube &cube, std::size_t axis, bool positive_direction,
+                                                      const std::unordered_map<const Cube *, bool> &drawn);
+
+public:
+    /// @param detail_factor Octants further away from the camera than their size multiplied by this factor are drawn
+    /// by their representative.
+    explicit OctreeLod(float detail_factor = 16.0F);
+
+    /// Select the level of detail of all octants for the camera position, and rebuild the polygons if needed.
+    /// @return true if the polygons have changed.
+    bool update(const Cube &root, const glm::vec3 &camera_position);
+
+    /// Polygons of the selection, faces of leaves in full detail are left out if they are hidden by what is drawn.
+    [[nodiscard]] const std::vector<Polygon> &polygons() const noexcept;
+    /// Cubes of the last update, in pre-order.
+    [[nodiscard]] const std::vector<Selection> &selection() const noexcept;
+};
+
+} // namespace inexor::vulkan_renderer::world
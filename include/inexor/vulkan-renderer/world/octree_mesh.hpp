@@ -0,0 +1,52 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Polygons of an octree, which are updated incrementally.
+/// Every geometry cube owns a range of faces (two polygons each), sized by its visible faces. Ranges of removed cubes
+/// are filled with degenerated polygons and reused later, so an edit only changes the ranges of the edited cubes and
+/// never moves other ranges. The polygons grow by doubling their number, so a growing mesh rarely changes its size. A
+/// mesh can contain several octrees, but a cube can only be part of one octree mesh at a time.
+class OctreeMesh {
+public:
+    /// Polygons of one face of a cube.
+    static constexpr std::size_t POLYGONS_PER_FACE = 2;
+    /// Faces of a cube.
+    static constexpr std::size_t FACES = Cube::POLYGONS / POLYGONS_PER_FACE;
+
+    /// Range of consecutive polygons.
+    struct PolygonRange {
+        std::uint32_t first;
+        std::uint32_t count;
+    };
+
+private:
+    std::vector<Polygon> m_polygons;
+    /// Number of faces of the range starting at the face, only valid for the first face of a range.
+    std::vector<std::uint8_t> m_range_faces;
+    /// First faces of released ranges, grouped by their number of faces.
+    std::array<std::vector<std::uint32_t>, FACES> m_free_ranges;
+
+    [[nodiscard]] std::uint32_t allocate_range(std::size_t faces);
+    void release_range(std::uint32_t first_face, std::vector<std::uint32_t> &changed_faces);
+    void write_range(const Cube &cube, std::vector<std::uint32_t> &changed_faces);
+
+public:
+    /// Regenerate the polygons of all dirty subtrees and clear their dirty flags.
+    /// @return The sorted and merged ranges of the changed polygons.
+    std::vector<PolygonRange> update(const Cube &root);
+    /// Release the ranges of all cubes of an octree, a later update writes them again.
+    /// @return The sorted and merged ranges of the changed polygons.
+    std::vector<PolygonRange> remove(const Cube &root);
+
+    /// Polygons of all ranges, including degenerated polygons of unused ranges and of the spare polygons at the end.
+    [[nodiscard]] const std::vector<Polygon> &polygons() const noexcept;
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <array>
+#include <memory>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Immutable cube of an octree snapshot. Unchanged subtrees are shared between snapshots and the octree.
+struct SnapshotNode {
+    Cube::Type type{Cube::Type::SOLID};
+    /// Only used by Type::NORMAL.
+    std::array<Indentation, Cube::EDGES> indentations{};
+    /// Only used by Type::OCTANT.
+    std::array<std::shared_ptr<const SnapshotNode>, Cube::SUB_CUBES> childs{};
+};
+
+/// Immutable state of an octree at the time it has been taken by Cube::snapshot.
+/// Copying a snapshot is O(1) and snapshots can be read by any thread without locks, as they are never modified.
+class OctreeSnapshot {
+private:
+    float m_size{32};
+    glm::vec3 m_position{0.0F, 0.0F, 0.0F};
+    std::shared_ptr<const SnapshotNode> m_root;
+
+public:
+    OctreeSnapshot(float size, const glm::vec3 &position, std::shared_ptr<const SnapshotNode> root);
+
+    /// Size of the root cube.
+    [[nodiscard]] float size() const noexcept;
+    /// Position of the root cube.
+    [[nodiscard]] glm::vec3 position() const noexcept;
+    /// Get the root node.
+    [[nodiscard]] const std::shared_ptr<const SnapshotNode> &root() const noexcept;
+
+    /// Convert into a new pointer based octree.
+    [[nodiscard]] std::shared_ptr<Cube> to_cube() const;
+    /// Count the number of Type::SOLID and Type::NORMAL cubes.
+    [[nodiscard]] std::size_t count_geometry_cubes() const;
+    /// Count the distinct nodes, nodes which are shared by several subtrees are counted once.
+    [[nodiscard]] std::size_t count_nodes() const;
+    /// Collect the polygons of all geometry cubes in the same order as Cube::polygons, but without hidden face removal.
+    [[nodiscard]] std::vector<Polygon> polygons() const;
+};
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,147 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+/// Stack of an octree traversal with one frame per octant which is currently visited.
+/// The first levels are stored inline, deeper octrees continue on the heap. Traversals may therefore throw
+/// std::bad_alloc, functions which traverse an octree must not be noexcept.
+template <typename CubeType>
+class TraversalStack {
+public:
+    struct Frame {
+        CubeType *cube;
+        const std::shared_ptr<Cube> *childs;
+        std::uint8_t next_child;
+    };
+
+private:
+    static constexpr std::size_t INLINE_FRAMES = 32;
+
+    std::array<Frame, INLINE_FRAMES> m_inline_frames;
+    std::vector<Frame> m_heap_frames;
+    Frame *m_frames{m_inline_frames.data()};
+    std::size_t m_capacity{INLINE_FRAMES};
+    std::size_t m_size{0};
+
+public:
+    TraversalStack() = default;
+    TraversalStack(const TraversalStack &) = delete;
+    TraversalStack(TraversalStack &&) = delete;
+    ~TraversalStack() = default;
+
+    TraversalStack &operator=(const TraversalStack &) = delete;
+    TraversalStack &operator=(TraversalStack &&) = delete;
+
+    /// \warning Invalidates references returned by top.
+    void push(CubeType *cube) {
+        if (m_size == m_capacity) {
+            // Move all frames to the heap once the inline frames are exhausted, so they stay contiguous.
+            std::vector<Frame> frames(m_capacity * 2);
+            std::copy(m_frames, m_frames + m_size, frames.begin());
+            m_heap_frames = std::move(frames);
+            m_frames = m_heap_frames.data();
+            m_capacity = m_heap_frames.size();
+        }
+        m_frames[m_size++] = {cube, cube->childs().data(), 0};
+    }
+
+    void pop() {
+        assert(m_size > 0);
+        m_size--;
+    }
+
+    [[nodiscard]] Frame &top() {
+        assert(m_size > 0);
+        return m_frames[m_size - 1];
+    }
+
+    [[nodiscard]] bool empty() const noexcept {
+        return m_size == 0;
+    }
+};
+
+/// Visit all cubes of an octree without recursion, children are visited in ascending order.
+/// The pre visitor is called before the children of a cube are visited. It can change the cube, e.g. its type, before
+/// the children are visited. If it returns a bool, false skips the children of the cube.
+/// The post visitor is called after all children of a cube have been visited.
+/// @param root Either a Cube or a const Cube.
+template <typename CubeType, typename PreVisitor, typename PostVisitor>
+void traverse_octree(CubeType &root, PreVisitor &&pre_visitor, PostVisitor &&post_visitor) {
+    static_assert(std::is_same_v<std::remove_const_t<CubeType>, Cube>, "Only cubes can be traversed.");
+
+    // Returns true if the children of the cube have to be visited.
+    const auto enter = [&pre_visitor](CubeType &cube) {
+        if constexpr (std::is_same_v<std::invoke_result_t<PreVisitor &, CubeType &>, bool>) {
+            return pre_visitor(cube) && cube.type() == Cube::Type::OCTANT;
+        } else {
+            pre_visitor(cube);
+            return cube.type() == Cube::Type::OCTANT;
+        }
+    };
+
+    if (!enter(root)) {
+        post_visitor(root);
+        return;
+    }
+    TraversalStack<CubeType> stack;
+    stack.push(&root);
+    while (!stack.empty()) {
+        auto &frame = stack.top();
+        CubeType *octant = nullptr;
+        while (frame.next_child < Cube::SUB_CUBES) {
+            CubeType *child = frame.childs[frame.next_child++].get();
+            if (enter(*child)) {
+                octant = child;
+                break;
+            }
+            post_visitor(*child);
+        }
+        if (octant != nullptr) {
+            stack.push(octant);
+            continue;
+        }
+        CubeType *cube = frame.cube;
+        stack.pop();
+        post_visitor(*cube);
+    }
+}
+
+/// Visit all cubes of an octree in pre-order, see traverse_octree.
+template <typename CubeType, typename Visitor>
+void visit_pre_order(CubeType &root, Visitor &&visitor) {
+    traverse_octree(root, std::forward<Visitor>(visitor), [](CubeType &) {});
+}
+
+/// Visit all cubes of an octree in post-order, see traverse_octree.
+template <typename CubeType, typename Visitor>
+void visit_post_order(CubeType &root, Visitor &&visitor) {
+    traverse_octree(root, [](CubeType &) {}, std::forward<Visitor>(visitor));
+}
+
+/// Visit all cubes of an octree which are not Type::OCTANT, in the same order as in pre-order.
+template <typename CubeType, typename Visitor>
+void visit_leaves(CubeType &root, Visitor &&visitor) {
+    traverse_octree(
+        root,
+        [&visitor](CubeType &cube) {
+            if (cube.type() == Cube::Type::OCTANT) {
+                return true;
+            }
+            visitor(cube);
+            return false;
+        },
+        [](CubeType &) {});
+}
+
+} // namespace inexor::vulkan_renderer::world
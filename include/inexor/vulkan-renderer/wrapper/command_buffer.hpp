@@ -60,9 +60,9 @@ public:
     void bind_graphics_pipeline(VkPipeline pipeline) const;
 
     /// @brief Call vkCmdBindIndexBuffer.
-    /// @todo Don't hardcode 16 for index bit width here.
     /// @param buffer The index buffer to bind.
-    void bind_index_buffer(VkBuffer buffer) const;
+    /// @param index_type The type of the indices in the buffer.
+    void bind_index_buffer(VkBuffer buffer, VkIndexType index_type) const;
 
     /// @brief Call vkCmdBindVertexBuffers.
     /// @param buffers A std::vector of vertex buffers to bind.
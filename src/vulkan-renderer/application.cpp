@@ -1,10 +1,13 @@
 ﻿#include "inexor/vulkan-renderer/application.hpp"
 
 #include "inexor/vulkan-renderer/exceptions/vk_exception.hpp"
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
 #include "inexor/vulkan-renderer/octree_gpu_vertex.hpp"
 #include "inexor/vulkan-renderer/standard_ubo.hpp"
 #include "inexor/vulkan-renderer/tools/cla_parser.hpp"
 #include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/greedy_mesh.hpp"
 #include "inexor/vulkan-renderer/wrapper/cpu_texture.hpp"
 #include "inexor/vulkan-renderer/wrapper/descriptor_builder.hpp"
 #include "inexor/vulkan-renderer/wrapper/instance.hpp"
@@ -15,9 +18,14 @@
 #include <spdlog/spdlog.h>
 #include <toml11/toml.hpp>
 
+#include <stdexcept>
 #include <thread>
 
 namespace inexor::vulkan_renderer {
+namespace {
+/// Name of the mesh cache entry of the octree, which is the only map so far.
+constexpr const char *OCTREE_MESH_CACHE_ENTRY = "world";
+} // namespace
 
 void Application::frame_buffer_resize_callback(GLFWwindow *window, int width, int height) {
     spdlog::debug("Frame buffer resize callback called. window width: {}, height: {}", width, height);
@@ -75,6 +83,21 @@ void Application::load_toml_configuration_file(const std::string &file_name) {
     m_window_title = toml::find<std::string>(renderer_configuration, "application", "window", "name");
     spdlog::debug("Window: '{}', {} x {}", m_window_title, m_window_width, m_window_height);
 
+    m_thread_pool_workers = toml::find<std::uint32_t>(renderer_configuration, "application", "threads", "workers");
+
+    m_chunk_directory = toml::find<std::string>(renderer_configuration, "application", "world", "chunk_directory");
+    m_mesh_cache_directory =
+        toml::find<std::string>(renderer_configuration, "application", "world", "mesh_cache_directory");
+    m_chunk_streamer_settings.chunk_size =
+        toml::find<float>(renderer_configuration, "application", "world", "chunk_size");
+    m_chunk_streamer_settings.load_radius =
+        toml::find<float>(renderer_configuration, "application", "world", "load_radius");
+    // The memory budgets are given in MiB.
+    m_chunk_streamer_settings.cpu_memory_budget =
+        toml::find<std::size_t>(renderer_configuration, "application", "world", "cpu_memory_budget") * 1024 * 1024;
+    m_chunk_streamer_settings.gpu_memory_budget =
+        toml::find<std::size_t>(renderer_configuration, "application", "world", "gpu_memory_budget") * 1024 * 1024;
+
     m_application_name = toml::find<std::string>(renderer_configuration, "application", "name");
     m_engine_name = toml::find<std::string>(renderer_configuration, "application", "engine", "name");
     spdlog::debug("Application name: '{}'", m_application_name);
@@ -194,26 +217,199 @@ void Application::load_shaders() {
 void Application::load_octree_geometry() {
     spdlog::debug("Creating octree geometry.");
 
-    std::shared_ptr<world::Cube> cube =
-        std::make_shared<world::Cube>(world::Cube::Type::OCTANT, 2.0f, glm::vec3{0, -1, -1});
-
-    cube->childs()[3]->set_type(world::Cube::Type::EMPTY);
-    cube->childs()[5]->set_type(world::Cube::Type::EMPTY);
-    cube->childs()[6]->set_type(world::Cube::Type::EMPTY);
-    cube->childs()[7]->set_type(world::Cube::Type::EMPTY);
-
-    for (const auto &polygons : cube->polygons(true)) {
-        for (const auto &triangle : *polygons) {
-            for (const auto &vertex : triangle) {
-                glm::vec3 color = {
-                    static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
-                    static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
-                    static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
-                };
+    // The root has to be owned by a shared pointer before it is subdivided, so changes are propagated up to it.
+    m_world = std::make_shared<world::Cube>(world::Cube::Type::SOLID, 2.0f, glm::vec3{0, -1, -1});
+    m_world->set_type(world::Cube::Type::OCTANT);
+
+    m_world->childs()[3]->set_type(world::Cube::Type::EMPTY);
+    m_world->childs()[5]->set_type(world::Cube::Type::EMPTY);
+    m_world->childs()[6]->set_type(world::Cube::Type::EMPTY);
+    m_world->childs()[7]->set_type(world::Cube::Type::EMPTY);
+
+    // The key covers everything the vertices and indices depend on, so an entry of a changed octree is never used.
+    std::uint64_t mesh_cache_key = 0;
+    if (m_mesh_cache) {
+        mesh_cache_key = io::MeshCache::key(io::serialize_octree(m_world, 0).data(), m_greedy_meshing ? 1 : 0);
+        if (auto mesh = m_mesh_cache->load(OCTREE_MESH_CACHE_ENTRY, mesh_cache_key)) {
+            m_octree_vertices = std::move(mesh->vertices);
+            m_octree_indices = std::move(mesh->indices);
+            m_patchable_mesh = nullptr;
+            m_mesh_cache_snapshot = m_world->snapshot();
+            spdlog::debug("Loaded octree mesh with {} vertices from the mesh cache.", m_octree_vertices.size());
+            return;
+        }
+    }
+
+    // Fill the polygon caches in parallel, so the octree mesh only has to copy them.
+    static_cast<void>(m_world->polygons(*m_thread_pool, true));
+    m_octree_mesh.update(*m_world);
+    m_octree_vertices.clear();
+    // The level of detail needs the camera, which does not exist yet. It replaces the mesh on the first frame.
+    // Streamed chunks replace the mesh as soon as the first chunks have been loaded.
+    if (m_greedy_meshing) {
+        copy_greedy_mesh();
+        generate_octree_indices();
+    } else {
+        copy_octree_mesh_polygons(m_octree_mesh, 0, m_octree_mesh.polygons().size());
+        generate_octree_identity_indices();
+        m_patchable_mesh = &m_octree_mesh;
+    }
+    spdlog::debug("Octree mesh has {} polygons, {} hidden polygons have been removed.", m_octree_mesh.polygons().size(),
+                  m_world->count_hidden_polygons());
+
+    if (m_mesh_cache) {
+        try {
+            m_mesh_cache->store(OCTREE_MESH_CACHE_ENTRY, mesh_cache_key, m_octree_vertices, m_octree_indices);
+        } catch (const std::runtime_error &exception) {
+            spdlog::warn("Could not store the octree mesh in the mesh cache: {}", exception.what());
+        }
+    }
+}
+
+void Application::copy_octree_mesh_polygons(const world::OctreeMesh &mesh, const std::size_t first_polygon,
+                                            const std::size_t polygon_count) {
+    const auto &polygons = mesh.polygons();
+
+    std::size_t vertex_index = first_polygon * 3;
+    m_octree_vertices.reserve((first_polygon + polygon_count) * 3);
+    for (std::size_t idx = first_polygon; idx < first_polygon + polygon_count; idx++) {
+        for (const auto &vertex : polygons[idx]) {
+            glm::vec3 color = {
+                static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
+                static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
+                static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
+            };
+            if (vertex_index < m_octree_vertices.size()) {
+                m_octree_vertices[vertex_index] = OctreeGpuVertex(vertex, color);
+            } else {
                 m_octree_vertices.emplace_back(vertex, color);
             }
+            vertex_index++;
+        }
+    }
+}
+
+void Application::copy_greedy_mesh() {
+    const auto polygons = world::greedy_mesh(*m_world);
+    spdlog::trace("Greedy octree mesh has {} polygons.", polygons.size());
+    copy_polygons(polygons);
+}
+
+void Application::copy_polygons(const std::vector<world::Polygon> &polygons) {
+    m_patchable_mesh = nullptr;
+    m_octree_vertices.clear();
+    m_octree_vertices.reserve(polygons.size() * 3);
+    for (const auto &polygon : polygons) {
+        for (const auto &vertex : polygon) {
+            glm::vec3 color = {
+                static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
+                static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
+                static_cast<float>(rand()) / static_cast<float>(RAND_MAX),
+            };
+            m_octree_vertices.emplace_back(vertex, color);
+        }
+    }
+}
+
+std::vector<world::OctreeMesh::PolygonRange> Application::update_chunk_mesh() {
+    std::vector<world::OctreeMesh::PolygonRange> changed_ranges;
+    const auto &chunks = m_chunk_streamer->chunks();
+    for (auto iter = m_meshed_chunks.begin(); iter != m_meshed_chunks.end();) {
+        const auto chunk = chunks.find(iter->first);
+        if (chunk != chunks.end() && chunk->second.root == iter->second) {
+            iter++;
+            continue;
         }
+        const auto ranges = m_chunk_mesh.remove(*iter->second);
+        changed_ranges.insert(changed_ranges.end(), ranges.begin(), ranges.end());
+        iter = m_meshed_chunks.erase(iter);
     }
+    for (const auto &[coordinate, chunk] : chunks) {
+        if (chunk.root == nullptr || m_meshed_chunks.count(coordinate) != 0) {
+            continue;
+        }
+        // The polygon caches have been filled while loading the chunk, so this only copies them.
+        const auto ranges = m_chunk_mesh.update(*chunk.root);
+        changed_ranges.insert(changed_ranges.end(), ranges.begin(), ranges.end());
+        m_meshed_chunks.emplace(coordinate, chunk.root);
+    }
+    return changed_ranges;
+}
+
+void Application::upload_octree_mesh(const world::OctreeMesh &mesh,
+                                     const std::vector<world::OctreeMesh::PolygonRange> &changed_ranges,
+                                     const bool rebuild) {
+    // Patching is only possible as long as every polygon of this mesh maps to its own three vertices, and as long as
+    // the mesh has not grown. The vertices of a patchable mesh are never merged, so they can be overwritten in place.
+    if (rebuild || m_patchable_mesh != &mesh || m_octree_vertices.size() != mesh.polygons().size() * 3) {
+        spdlog::trace("Rebuilding octree vertices, as the octree mesh layout has changed.");
+        m_octree_vertices.clear();
+        copy_octree_mesh_polygons(mesh, 0, mesh.polygons().size());
+        generate_octree_identity_indices();
+        m_patchable_mesh = &mesh;
+        recreate_frame_graph();
+        return;
+    }
+
+    if (changed_ranges.empty()) {
+        return;
+    }
+    // The vertex buffer is only written once the GPU has finished all frames which use it.
+    vkDeviceWaitIdle(m_device->device());
+    for (const auto &range : changed_ranges) {
+        copy_octree_mesh_polygons(mesh, range.first, range.count);
+        update_octree_vertices(range.first * 3, range.count * 3);
+    }
+}
+
+void Application::update_octree_geometry() {
+    // Chunks are loaded in the background, only the ranges of the chunks which have been loaded or evicted are
+    // uploaded. The chunk mesh replaces the octree mesh once the first chunks have been loaded.
+    if (m_chunk_streamer) {
+        if (m_chunk_streamer->update(m_camera->position())) {
+            const auto &metrics = m_chunk_streamer->metrics();
+            spdlog::trace("{} world chunks are resident, {} chunks have been evicted.", metrics.resident_chunks,
+                          metrics.evicted_chunks);
+            const bool first_chunks = m_meshed_chunks.empty();
+            const auto changed_ranges = update_chunk_mesh();
+            upload_octree_mesh(m_chunk_mesh, changed_ranges, first_chunks);
+        }
+        return;
+    }
+
+    // The level of detail depends on the camera, so it is checked every frame. It only rebuilds on a new selection.
+    if (m_octree_lod_enabled) {
+        if (m_octree_lod.update(*m_world, m_camera->position())) {
+            spdlog::trace("Octree level of detail has {} polygons.", m_octree_lod.polygons().size());
+            copy_polygons(m_octree_lod.polygons());
+            generate_octree_indices();
+            recreate_frame_graph();
+        }
+        return;
+    }
+
+    // The mesh of the mesh cache is used until the octree is changed, only then the octree mesh is generated.
+    if (m_mesh_cache_snapshot) {
+        if (m_world->snapshot().root() == m_mesh_cache_snapshot->root()) {
+            return;
+        }
+        m_mesh_cache_snapshot.reset();
+    }
+
+    const auto changed_ranges = m_octree_mesh.update(*m_world);
+    if (changed_ranges.empty()) {
+        return;
+    }
+
+    // The merged faces of the greedy mesh depend on each other, so it is always rebuilt completely.
+    if (m_greedy_meshing) {
+        copy_greedy_mesh();
+        generate_octree_indices();
+        recreate_frame_graph();
+        return;
+    }
+
+    upload_octree_mesh(m_octree_mesh, changed_ranges, false);
 }
 
 void Application::check_application_specific_features() {
@@ -287,7 +483,6 @@ void Application::setup_window_and_input_callbacks() {
 
 Application::Application(int argc, char **argv) {
     spdlog::debug("Initialising vulkan-renderer.");
-    spdlog::debug("Initialising thread-pool with {} threads.", std::thread::hardware_concurrency());
 
     tools::CommandLineArgumentParser cla_parser;
     cla_parser.parse_args(argc, argv);
@@ -295,6 +490,26 @@ Application::Application(int argc, char **argv) {
     // Load the configuration from the TOML file.
     load_toml_configuration_file("configuration/renderer.toml");
 
+    // The command line argument "--threads" overwrites the number of workers of the configuration file.
+    if (const auto thread_pool_workers = cla_parser.arg<std::uint32_t>("--threads")) {
+        m_thread_pool_workers = *thread_pool_workers;
+    }
+    m_thread_pool = std::make_unique<tools::ThreadPool>(m_thread_pool_workers);
+    spdlog::debug("Initialising thread-pool with {} threads.", m_thread_pool->worker_count());
+
+    if (!m_mesh_cache_directory.empty() && !cla_parser.arg<bool>("--no-mesh-cache").value_or(false)) {
+        spdlog::debug("Caching octree meshes in '{}'.", m_mesh_cache_directory);
+        m_mesh_cache = std::make_unique<io::MeshCache>(m_mesh_cache_directory);
+    }
+
+    if (!m_chunk_directory.empty()) {
+        spdlog::debug("Streaming world chunks of size {} from '{}' within a radius of {}.",
+                      m_chunk_streamer_settings.chunk_size, m_chunk_directory, m_chunk_streamer_settings.load_radius);
+        m_chunk_streamer_settings.vertex_size = sizeof(OctreeGpuVertex);
+        m_chunk_streamer = std::make_unique<world::ChunkStreamer>(
+            *m_thread_pool, world::ChunkStreamer::directory_loader(m_chunk_directory), m_chunk_streamer_settings);
+    }
+
     bool enable_renderdoc_instance_layer = false;
 
     auto enable_renderdoc = cla_parser.arg<bool>("--renderdoc");
@@ -428,6 +643,16 @@ Application::Application(int argc, char **argv) {
         display_graphics_card_info = false;
     }
 
+    if (cla_parser.arg<bool>("--greedy-meshing").value_or(false)) {
+        spdlog::debug("--greedy-meshing specified, coplanar faces of solid cubes will be merged.");
+        m_greedy_meshing = true;
+    }
+
+    if (cla_parser.arg<bool>("--octree-lod").value_or(false)) {
+        spdlog::debug("--octree-lod specified, distant octants will be drawn by a single cube.");
+        m_octree_lod_enabled = true;
+    }
+
     // If the user specified command line argument "--vsync", the presentation engine waits
     // for the next vertical blanking period to update the current image.
     const auto enable_vertical_synchronisation = cla_parser.arg<bool>("--vsync");
@@ -495,7 +720,6 @@ Application::Application(int argc, char **argv) {
             .build("Default uniform buffer"));
 
     load_octree_geometry();
-    generate_octree_indices();
 
     spdlog::debug("Vulkan initialisation finished.");
     spdlog::debug("Showing window.");
@@ -549,6 +773,16 @@ void Application::update_imgui_overlay() {
     ImGui::Text("Yaw: %.2f pitch: %.2f roll: %.2f", m_camera->yaw(), m_camera->pitch(), m_camera->roll());
     const auto cam_fov = m_camera->fov();
     ImGui::Text("Field of view: %d", static_cast<std::uint32_t>(cam_fov));
+    if (m_chunk_streamer) {
+        const auto &metrics = m_chunk_streamer->metrics();
+        ImGui::Text("Chunks: %zu resident, %zu loading, %zu evicted", metrics.resident_chunks, metrics.pending_loads,
+                    metrics.evicted_chunks);
+        ImGui::Text("Chunk memory: %zu MiB CPU, %zu MiB GPU", metrics.cpu_memory / (1024 * 1024),
+                    metrics.gpu_memory / (1024 * 1024));
+        ImGui::Text("Chunk load latency: %.2f ms (max %.2f ms)",
+                    static_cast<float>(metrics.average_load_latency().count()) / 1000.0f,
+                    static_cast<float>(metrics.max_load_latency.count()) / 1000.0f);
+    }
     ImGui::PushItemWidth(150.0f * m_imgui_overlay->get_scale());
     ImGui::PopItemWidth();
     ImGui::End();
@@ -579,6 +813,7 @@ void Application::run() {
         m_window->poll();
         update_uniform_buffers();
         update_imgui_overlay();
+        update_octree_geometry();
         render_frame();
         process_mouse_input();
         m_camera->update(m_time_passed);
@@ -9,6 +9,8 @@
 
 #include <array>
 #include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <stdexcept>
 #include <unordered_map>
@@ -166,7 +168,10 @@ void FrameGraph::record_command_buffers(const RenderStage *stage, PhysicalStage
             assert(phys_buffer != nullptr);
 
             if (buffer_resource->m_usage == BufferUsage::INDEX_BUFFER) {
-                cmd_buf.bind_index_buffer(phys_buffer->m_buffer);
+                // The index type follows from the type of the uploaded indices.
+                const auto index_type = buffer_resource->m_element_size == sizeof(std::uint32_t) ? VK_INDEX_TYPE_UINT32
+                                                                                                  : VK_INDEX_TYPE_UINT16;
+                cmd_buf.bind_index_buffer(phys_buffer->m_buffer, index_type);
             } else if (buffer_resource->m_usage == BufferUsage::VERTEX_BUFFER) {
                 vertex_buffers.push_back(phys_buffer->m_buffer);
             }
@@ -508,6 +513,21 @@ void FrameGraph::compile(const RenderResource &target) {
     }
 }
 
+void FrameGraph::update_buffer(const BufferResource &resource, const std::size_t offset, const void *data,
+                               const std::size_t size) const {
+    assert(resource.m_data != nullptr);
+    assert(offset + size <= resource.m_data_size);
+    const auto *phys = m_resource_map.at(&resource)->as<PhysicalBuffer>();
+    assert(phys != nullptr);
+
+    // Buffers with data to upload are persistently mapped.
+    VmaAllocationInfo alloc_info;
+    vmaGetAllocationInfo(m_device.allocator(), phys->m_allocation, &alloc_info);
+    assert(alloc_info.pMappedData != nullptr);
+    std::memcpy(static_cast<std::uint8_t *>(alloc_info.pMappedData) + offset, data, size);
+    vmaFlushAllocation(m_device.allocator(), phys->m_allocation, offset, size);
+}
+
 void FrameGraph::render(int image_index, VkSemaphore signal_semaphore, VkSemaphore wait_semaphore,
                         VkQueue graphics_queue) const {
     auto submit_info = wrapper::make_info<VkSubmitInfo>();
@@ -0,0 +1,27 @@
+#include "inexor/vulkan-renderer/io/byte_sink.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+namespace inexor::vulkan_renderer::io {
+FileSink::FileSink(std::filesystem::path path)
+    : m_path(std::move(path)), m_file(m_path, std::ios::out | std::ios::binary | std::ios::trunc) {
+    if (!m_file) {
+        throw std::runtime_error("Could not open file " + m_path.string() + " for writing.");
+    }
+}
+
+void FileSink::write_bytes(const tools::Span<const std::uint8_t> bytes) {
+    m_file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!m_file) {
+        throw std::runtime_error("Could not write to file " + m_path.string() + ".");
+    }
+}
+
+void FileSink::flush() {
+    m_file.flush();
+    if (!m_file) {
+        throw std::runtime_error("Could not write to file " + m_path.string() + ".");
+    }
+}
+} // namespace inexor::vulkan_renderer::io
@@ -1,61 +1,109 @@
 #include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/byte_sink.hpp"
+#include "inexor/vulkan-renderer/io/mapped_file.hpp"
 #include "inexor/vulkan-renderer/world/cube.hpp"
 
+#include <algorithm>
 #include <fstream>
+#include <stdexcept>
 
 namespace inexor::vulkan_renderer::io {
 std::vector<std::uint8_t> ByteStream::read_file(const std::filesystem::path &path) {
     std::ifstream stream(path, std::ios::in | std::ios::binary);
-    return {std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>()};
+    if (!stream) {
+        return {};
+    }
+    // Read the whole file at once instead of byte by byte.
+    stream.seekg(0, std::ios::end);
+    std::vector<std::uint8_t> buffer(static_cast<std::size_t>(stream.tellg()));
+    stream.seekg(0, std::ios::beg);
+    stream.read(reinterpret_cast<char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    buffer.resize(static_cast<std::size_t>(stream.gcount()));
+    return buffer;
 }
 
 ByteStream::ByteStream(std::vector<std::uint8_t> buffer) : m_buffer(std::move(buffer)) {}
 
-ByteStream::ByteStream(const std::filesystem::path &path) : ByteStream(read_file(path)) {}
+ByteStream::ByteStream(const std::filesystem::path &path) {
+    if constexpr (MappedFile::SUPPORTED) {
+        try {
+            m_mapping = std::make_shared<const MappedFile>(path);
+            return;
+        } catch (const std::runtime_error &) {
+            // Fall back to reading the file, which results in an empty stream if it can't be read either.
+        }
+    }
+    m_buffer = read_file(path);
+}
+
+ByteStream ByteStream::read_from_file(const std::filesystem::path &path) {
+    return ByteStream(read_file(path));
+}
 
 std::size_t ByteStream::size() const {
-    return m_buffer.size();
+    return data().size();
 }
-const std::vector<std::uint8_t> &ByteStream::buffer() const {
-    return m_buffer;
+
+tools::Span<const std::uint8_t> ByteStream::data() const {
+    return m_mapping != nullptr ? m_mapping->data() : tools::Span<const std::uint8_t>(m_buffer);
 }
 
-void ByteStreamReader::check_end(const std::size_t size) const {
-    if (static_cast<std::size_t>(std::distance(m_iter, m_stream.buffer().end())) < size) {
-        throw std::runtime_error("end would be overrun");
-    }
+bool ByteStream::is_mapped() const noexcept {
+    return m_mapping != nullptr;
 }
 
-ByteStreamReader::ByteStreamReader(const ByteStream &stream) : m_stream(stream), m_iter(stream.buffer().begin()) {}
+void ByteStreamReader::throw_end_overrun() {
+    throw std::runtime_error("end would be overrun");
+}
+
+ByteStreamReader::ByteStreamReader(const ByteStream &stream)
+    : m_iter(stream.data().begin()), m_end(stream.data().end()) {}
+
+ByteStreamReader::ByteStreamReader(const ByteStream &stream, const std::size_t offset, const std::size_t size)
+    : ByteStreamReader(stream) {
+    if (offset > remaining() || size > remaining() - offset) {
+        throw std::runtime_error("Part is not within the stream.");
+    }
+    m_iter += offset;
+    m_end = m_iter + size;
+}
 
 void ByteStreamReader::skip(const std::size_t size) {
-    const std::size_t skip = std::min(
-        size, std::size_t(std::distance<std::vector<std::uint8_t>::const_iterator>(m_iter, m_stream.buffer().end())));
-    std::advance(m_iter, skip);
+    m_iter += std::min(size, remaining());
 }
 
 std::size_t ByteStreamReader::remaining() const {
-    return std::distance<std::vector<std::uint8_t>::const_iterator>(m_iter, m_stream.buffer().end());
+    return static_cast<std::size_t>(m_end - m_iter);
+}
+
+tools::Span<const std::uint8_t> ByteStreamReader::read_span(const std::size_t size) {
+    check_end(size);
+    return read_span_unchecked(size);
 }
 
 template <>
 std::uint8_t ByteStreamReader::read() {
     check_end(1);
-    return *m_iter++;
+    return read_byte_unchecked();
 }
 
 template <>
 std::uint32_t ByteStreamReader::read() {
     check_end(4);
-    return (*m_iter++ << 0U) | (*m_iter++ << 8U) | (*m_iter++ << 16U) | (*m_iter++ << 24U);
+    return read_uint32_unchecked();
+}
+
+template <>
+std::uint64_t ByteStreamReader::read() {
+    check_end(8);
+    const std::uint64_t high = read_uint32_unchecked();
+    return (high << 32U) | read_uint32_unchecked();
 }
 
 template <>
 std::string ByteStreamReader::read(const std::size_t &size) {
-    check_end(size);
-    auto start = m_iter;
-    std::advance(m_iter, size);
-    return std::string(start, m_iter);
+    const auto bytes = read_span(size);
+    return std::string(bytes.begin(), bytes.end());
 }
 
 template <>
@@ -65,22 +113,54 @@ world::Cube::Type ByteStreamReader::read() {
 
 template <>
 std::array<world::Indentation, 12> ByteStreamReader::read() {
-    check_end(9);
-    std::array<world::Indentation, 12> indentations;
-    auto writer = indentations.begin();
-    const auto end = m_iter + 9;
-    while (m_iter != end) {
-        *writer++ = world::Indentation(*m_iter >> 2U);
-        *writer++ = world::Indentation(((*m_iter & 0b00000011U) << 4U) | (*(++m_iter) >> 4U));
-        *writer++ = world::Indentation(((*m_iter & 0b00001111U) << 2U) | (*(++m_iter) >> 6U));
-        *writer++ = world::Indentation(*m_iter++ & 0b00111111U);
+    const auto packed = read_span(world::Indentation::PACKED_EDGES_SIZE);
+    std::array<std::uint8_t, world::Indentation::PACKED_EDGES_SIZE> bytes;
+    std::copy_n(packed.begin(), bytes.size(), bytes.begin());
+    return world::Indentation::unpack(bytes);
+}
+
+ByteStreamWriter::ByteStreamWriter(ByteSink &sink, const std::size_t block_size)
+    : m_sink(&sink), m_block_size(block_size) {
+    assert(block_size > 0);
+    m_buffer.reserve(block_size);
+    m_flushing_block.reserve(block_size);
+}
+
+ByteStreamWriter::~ByteStreamWriter() {
+    if (m_pending_flush.valid()) {
+        m_pending_flush.wait();
+    }
+}
+
+void ByteStreamWriter::wait_for_flush() {
+    if (m_pending_flush.valid()) {
+        m_pending_flush.get();
     }
-    return indentations;
+}
+
+void ByteStreamWriter::flush_block() {
+    wait_for_flush();
+    // The buffers are swapped instead of copied, the cleared buffer keeps its capacity for the next block.
+    std::swap(m_buffer, m_flushing_block);
+    m_buffer.clear();
+    m_pending_flush = std::async(std::launch::async, [this] { m_sink->write_bytes(m_flushing_block); });
+}
+
+void ByteStreamWriter::finish() {
+    if (m_sink == nullptr) {
+        return;
+    }
+    if (!m_buffer.empty()) {
+        flush_block();
+    }
+    wait_for_flush();
+    m_sink->flush();
 }
 
 template <>
 void ByteStreamWriter::write(const std::uint8_t &value) {
     m_buffer.emplace_back(value);
+    flush_full_block();
 }
 
 template <>
@@ -89,11 +169,25 @@ void ByteStreamWriter::write(const std::uint32_t &value) {
     m_buffer.emplace_back(value >> 16U);
     m_buffer.emplace_back(value >> 8U);
     m_buffer.emplace_back(value);
+    flush_full_block();
+}
+
+template <>
+void ByteStreamWriter::write(const std::uint64_t &value) {
+    write(static_cast<std::uint32_t>(value >> 32U));
+    write(static_cast<std::uint32_t>(value));
+}
+
+template <>
+void ByteStreamWriter::write(const tools::Span<const std::uint8_t> &value) {
+    m_buffer.insert(m_buffer.end(), value.begin(), value.end());
+    flush_full_block();
 }
 
 template <>
 void ByteStreamWriter::write(const std::string &value) {
     std::copy(value.begin(), value.end(), std::back_inserter(m_buffer));
+    flush_full_block();
 }
 
 template <>
@@ -103,10 +197,8 @@ void ByteStreamWriter::write(const world::Cube::Type &value) {
 
 template <>
 void ByteStreamWriter::write(const std::array<world::Indentation, 12> &value) {
-    for (auto iter = value.begin(); iter != value.end(); iter++) {
-        write<std::uint8_t>((iter->uid() << 2U) | ((++iter)->uid() >> 4));
-        write<std::uint8_t>((iter->uid() << 4U) | ((++iter)->uid() >> 2));
-        write<std::uint8_t>((iter->uid() << 6U) | ((++iter)->uid()));
-    }
+    const auto bytes = world::Indentation::pack(value);
+    m_buffer.insert(m_buffer.end(), bytes.begin(), bytes.end());
+    flush_full_block();
 }
 } // namespace inexor::vulkan_renderer::io
@@ -0,0 +1,159 @@
+#include "inexor/vulkan-renderer/io/compression.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace inexor::vulkan_renderer::io {
+namespace {
+/// Shorter matches cost more than the literals they replace.
+constexpr std::size_t MIN_MATCH = 4;
+/// The largest offset which fits into the std::uint16_t of a sequence.
+constexpr std::size_t MAX_OFFSET = 65535;
+/// Lengths of this value in the token are continued by bytes.
+constexpr std::size_t TOKEN_LENGTH_LIMIT = 15;
+/// Positions of the last sequences of four bytes are found by a hash table of 2^16 entries.
+constexpr std::size_t HASH_BITS = 16;
+
+std::uint32_t load_uint32(const std::uint8_t *bytes) {
+    std::uint32_t value;
+    std::memcpy(&value, bytes, sizeof(value));
+    return value;
+}
+
+std::size_t hash(const std::uint32_t sequence) {
+    return (sequence * 2654435761U) >> (32 - HASH_BITS);
+}
+
+/// Write the rest of a length which does not fit into the token.
+void write_length(std::vector<std::uint8_t> &output, std::size_t length) {
+    for (; length >= 255; length -= 255) {
+        output.push_back(255);
+    }
+    output.push_back(static_cast<std::uint8_t>(length));
+}
+
+/// Write a sequence, a match length of zero writes the last sequence.
+void write_sequence(std::vector<std::uint8_t> &output, const std::uint8_t *literals, const std::size_t literal_count,
+                    const std::size_t offset, const std::size_t match_length) {
+    const std::size_t match_code = match_length == 0 ? 0 : match_length - MIN_MATCH;
+    output.push_back(static_cast<std::uint8_t>((std::min(literal_count, TOKEN_LENGTH_LIMIT) << 4U) |
+                                               std::min(match_code, TOKEN_LENGTH_LIMIT)));
+    if (literal_count >= TOKEN_LENGTH_LIMIT) {
+        write_length(output, literal_count - TOKEN_LENGTH_LIMIT);
+    }
+    output.insert(output.end(), literals, literals + literal_count);
+    if (match_length == 0) {
+        return;
+    }
+    output.push_back(static_cast<std::uint8_t>(offset));
+    output.push_back(static_cast<std::uint8_t>(offset >> 8U));
+    if (match_code >= TOKEN_LENGTH_LIMIT) {
+        write_length(output, match_code - TOKEN_LENGTH_LIMIT);
+    }
+}
+
+[[noreturn]] void throw_corrupted() {
+    throw std::runtime_error("Compressed bytes are corrupted.");
+}
+} // namespace
+
+std::vector<std::uint8_t> compress(const tools::Span<const std::uint8_t> bytes) {
+    const std::uint8_t *data = bytes.data();
+    const std::size_t size = bytes.size();
+    std::vector<std::uint8_t> output;
+    output.reserve(size / 2 + 16);
+    // Positions are stored plus one, so zero is an empty entry.
+    std::vector<std::size_t> positions(std::size_t(1) << HASH_BITS, 0);
+
+    std::size_t literal_start = 0;
+    std::size_t pos = 0;
+    while (pos + MIN_MATCH <= size) {
+        const std::uint32_t sequence = load_uint32(data + pos);
+        std::size_t &entry = positions[hash(sequence)];
+        const std::size_t candidate = entry;
+        entry = pos + 1;
+        if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET || load_uint32(data + candidate - 1) != sequence) {
+            pos++;
+            continue;
+        }
+        const std::size_t match = candidate - 1;
+        std::size_t length = MIN_MATCH;
+        while (pos + length < size && data[match + length] == data[pos + length]) {
+            length++;
+        }
+        write_sequence(output, data + literal_start, pos - literal_start, pos - match, length);
+        pos += length;
+        literal_start = pos;
+    }
+    write_sequence(output, data + literal_start, size - literal_start, 0, 0);
+    return output;
+}
+
+std::vector<std::uint8_t> decompress(const tools::Span<const std::uint8_t> bytes, const std::size_t size) {
+    // A compressed byte expands to at most 255 bytes, larger sizes are corrupted and must not be allocated.
+    if (size / 255 > bytes.size()) {
+        throw_corrupted();
+    }
+    std::vector<std::uint8_t> output(size);
+    const std::uint8_t *input = bytes.begin();
+    const std::uint8_t *input_end = bytes.end();
+    std::size_t output_pos = 0;
+
+    const auto read_length = [&](std::size_t length) {
+        if (length == TOKEN_LENGTH_LIMIT) {
+            std::uint8_t byte = 255;
+            while (byte == 255) {
+                if (input == input_end) {
+                    throw_corrupted();
+                }
+                byte = *input++;
+                length += byte;
+            }
+        }
+        return length;
+    };
+
+    while (true) {
+        if (input == input_end) {
+            throw_corrupted();
+        }
+        const std::uint8_t token = *input++;
+        const std::size_t literal_count = read_length(token >> 4U);
+        if (literal_count > static_cast<std::size_t>(input_end - input) || literal_count > size - output_pos) {
+            throw_corrupted();
+        }
+        std::copy_n(input, literal_count, output.begin() + static_cast<std::ptrdiff_t>(output_pos));
+        input += literal_count;
+        output_pos += literal_count;
+        if (input == input_end) {
+            break;
+        }
+
+        if (input_end - input < 2) {
+            throw_corrupted();
+        }
+        const std::size_t offset = input[0] | static_cast<std::size_t>(input[1]) << 8U;
+        input += 2;
+        const std::size_t length = read_length(token & 0xFU) + MIN_MATCH;
+        if (offset == 0 || offset > output_pos || length > size - output_pos) {
+            throw_corrupted();
+        }
+        std::uint8_t *target = output.data() + output_pos;
+        const std::uint8_t *source = target - offset;
+        if (offset >= length) {
+            std::copy_n(source, length, target);
+        } else {
+            // The match overlaps with itself, e.g. a run of a single byte.
+            for (std::size_t idx = 0; idx < length; idx++) {
+                target[idx] = source[idx];
+            }
+        }
+        output_pos += length;
+    }
+    if (output_pos != size) {
+        throw_corrupted();
+    }
+    return output;
+}
+} // namespace inexor::vulkan_renderer::io
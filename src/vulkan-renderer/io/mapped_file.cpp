@@ -0,0 +1,59 @@
+#include "inexor/vulkan-renderer/io/mapped_file.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace inexor::vulkan_renderer::io {
+#if defined(__unix__) || defined(__APPLE__)
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    const int file = open(path.c_str(), O_RDONLY);
+    if (file == -1) {
+        throw std::runtime_error("Could not open file " + path.string() + ".");
+    }
+    struct stat status {};
+    if (fstat(file, &status) == -1) {
+        close(file);
+        throw std::runtime_error("Could not get the size of file " + path.string() + ".");
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    // Empty files can't be mapped, there is nothing to read anyway.
+    if (m_size == 0) {
+        close(file);
+        return;
+    }
+    void *data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+    // The mapping stays valid after the file descriptor has been closed.
+    close(file);
+    if (data == MAP_FAILED) {
+        throw std::runtime_error("Could not map file " + path.string() + ".");
+    }
+    // Files are usually parsed from the front to the back, so the kernel should read ahead aggressively.
+    madvise(data, m_size, MADV_SEQUENTIAL);
+    m_data = static_cast<const std::uint8_t *>(data);
+}
+
+MappedFile::~MappedFile() {
+    if (m_data != nullptr) {
+        munmap(const_cast<std::uint8_t *>(m_data), m_size);
+    }
+}
+#else
+MappedFile::MappedFile(const std::filesystem::path &path) {
+    throw std::runtime_error("Memory mapped files are not supported on this platform, can't map " + path.string() +
+                             ".");
+}
+
+MappedFile::~MappedFile() = default;
+#endif
+
+tools::Span<const std::uint8_t> MappedFile::data() const noexcept {
+    return {m_data, m_size};
+}
+} // namespace inexor::vulkan_renderer::io
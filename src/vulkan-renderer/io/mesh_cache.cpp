@@ -0,0 +1,142 @@
+#include "inexor/vulkan-renderer/io/mesh_cache.hpp"
+#include "inexor/vulkan-renderer/io/byte_sink.hpp"
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <array>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+namespace inexor::vulkan_renderer::io {
+namespace {
+constexpr std::array<char, 12> IDENTIFIER{"Inexor Mesh"};
+/// Increase on every change of the layout of an entry, older entries become stale.
+constexpr std::uint32_t CACHE_VERSION = 1;
+
+/// Header of an entry, the vertices and the indices follow right after it.
+struct Header {
+    std::array<char, 12> identifier;
+    std::uint32_t version;
+    std::uint32_t vertex_size;
+    std::uint32_t index_size;
+    std::uint64_t key;
+    std::uint64_t vertex_count;
+    std::uint64_t index_count;
+    /// Hash of the vertices and the indices.
+    std::uint64_t checksum;
+};
+// The header is written as it is, so it must not contain any padding bytes.
+static_assert(sizeof(Header) == 56);
+static_assert(std::is_trivially_copyable_v<OctreeGpuVertex> && sizeof(OctreeGpuVertex) == 6 * sizeof(float));
+
+constexpr std::uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+
+std::uint64_t rotate_left(const std::uint64_t value, const unsigned bits) noexcept {
+    return (value << bits) | (value >> (64U - bits));
+}
+
+/// Hash of bytes, eight bytes per step. The bytes are loaded in the byte order of the machine, just as the entries.
+std::uint64_t hash_bytes(const tools::Span<const std::uint8_t> bytes, const std::uint64_t seed) noexcept {
+    std::uint64_t hash = seed ^ (bytes.size() * PRIME_1);
+    std::size_t idx = 0;
+    for (; idx + sizeof(std::uint64_t) <= bytes.size(); idx += sizeof(std::uint64_t)) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes.data() + idx, sizeof(word));
+        hash = rotate_left(hash ^ (word * PRIME_2), 31) * PRIME_1;
+    }
+    for (; idx < bytes.size(); idx++) {
+        hash = rotate_left(hash ^ (bytes[idx] * PRIME_1), 11) * PRIME_2;
+    }
+    // Final mix of MurmurHash3, so every input bit affects every output bit.
+    hash ^= hash >> 33U;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33U;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33U;
+    return hash;
+}
+
+template <typename T>
+tools::Span<const std::uint8_t> as_bytes(const std::vector<T> &values) noexcept {
+    return {reinterpret_cast<const std::uint8_t *>(values.data()), values.size() * sizeof(T)};
+}
+
+std::uint64_t checksum(const tools::Span<const std::uint8_t> vertices, const tools::Span<const std::uint8_t> indices) {
+    return hash_bytes(indices, hash_bytes(vertices, 0));
+}
+} // namespace
+
+MeshCache::MeshCache(std::filesystem::path directory) : m_directory(std::move(directory)) {}
+
+std::filesystem::path MeshCache::entry_path(const std::string &name) const {
+    return m_directory / (name + ".nxmc");
+}
+
+std::uint64_t MeshCache::key(const tools::Span<const std::uint8_t> serialized_octree, const std::uint64_t variant) {
+    const std::array<std::uint64_t, 2> seed{MESHER_VERSION, variant};
+    return hash_bytes(serialized_octree, hash_bytes({reinterpret_cast<const std::uint8_t *>(seed.data()), sizeof(seed)}, 0));
+}
+
+std::optional<MeshCache::Mesh> MeshCache::load(const std::string &name, const std::uint64_t key) const {
+    const ByteStream stream(entry_path(name));
+    const auto bytes = stream.data();
+    Header header;
+    if (bytes.size() < sizeof(header)) {
+        return std::nullopt;
+    }
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    const std::size_t payload_size = bytes.size() - sizeof(header);
+    if (header.identifier != IDENTIFIER || header.version != CACHE_VERSION ||
+        header.vertex_size != sizeof(OctreeGpuVertex) || header.index_size != sizeof(std::uint32_t) ||
+        header.key != key || header.vertex_count > payload_size / sizeof(OctreeGpuVertex) ||
+        header.index_count > payload_size / sizeof(std::uint32_t) ||
+        payload_size != header.vertex_count * sizeof(OctreeGpuVertex) + header.index_count * sizeof(std::uint32_t)) {
+        spdlog::debug("Mesh cache entry '{}' is stale.", name);
+        return std::nullopt;
+    }
+    const auto vertex_bytes = bytes.subspan(sizeof(header), header.vertex_count * sizeof(OctreeGpuVertex));
+    const auto index_bytes =
+        bytes.subspan(sizeof(header) + vertex_bytes.size(), header.index_count * sizeof(std::uint32_t));
+    if (checksum(vertex_bytes, index_bytes) != header.checksum) {
+        spdlog::debug("Mesh cache entry '{}' is corrupted.", name);
+        return std::nullopt;
+    }
+
+    // Both arrays are aligned, as the header size is a multiple of the alignment of the vertices and the indices.
+    Mesh mesh;
+    const auto *vertices = reinterpret_cast<const OctreeGpuVertex *>(vertex_bytes.data());
+    mesh.vertices.assign(vertices, vertices + header.vertex_count);
+    const auto *indices = reinterpret_cast<const std::uint32_t *>(index_bytes.data());
+    mesh.indices.assign(indices, indices + header.index_count);
+    return mesh;
+}
+
+void MeshCache::store(const std::string &name, const std::uint64_t key, const std::vector<OctreeGpuVertex> &vertices,
+                      const std::vector<std::uint32_t> &indices) const {
+    Header header{IDENTIFIER,
+                  CACHE_VERSION,
+                  sizeof(OctreeGpuVertex),
+                  sizeof(std::uint32_t),
+                  key,
+                  vertices.size(),
+                  indices.size(),
+                  checksum(as_bytes(vertices), as_bytes(indices))};
+
+    std::filesystem::create_directories(m_directory);
+    const auto path = entry_path(name);
+    auto temporary_path = path;
+    temporary_path += ".tmp";
+    {
+        FileSink sink(temporary_path);
+        sink.write_bytes({reinterpret_cast<const std::uint8_t *>(&header), sizeof(header)});
+        sink.write_bytes(as_bytes(vertices));
+        sink.write_bytes(as_bytes(indices));
+        sink.flush();
+    }
+    // The entry which might be mapped by a reader is replaced, but never truncated.
+    std::filesystem::rename(temporary_path, path);
+}
+} // namespace inexor::vulkan_renderer::io
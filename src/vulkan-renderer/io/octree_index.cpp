@@ -0,0 +1,225 @@
+#include "inexor/vulkan-renderer/io/octree_index.hpp"
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <cassert>
+#include <exception>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+namespace inexor::vulkan_renderer::io {
+namespace {
+/// Level 10 already has up to a billion subtrees.
+constexpr std::uint32_t MAX_INDEX_LEVEL = 10;
+
+/// Position of the reader in the stream.
+std::size_t reader_position(const ByteStream &stream, const ByteStreamReader &reader) {
+    return stream.size() - reader.remaining();
+}
+
+/// Skip the records of a subtree by their types, without creating any cubes.
+void skip_subtree(ByteStreamReader &reader) {
+    for (std::size_t pending_cubes = 1; pending_cubes > 0; pending_cubes--) {
+        switch (reader.read<world::Cube::Type>()) {
+        case world::Cube::Type::NORMAL:
+            static_cast<void>(reader.read_span(world::Indentation::PACKED_EDGES_SIZE));
+            break;
+        case world::Cube::Type::OCTANT:
+            pending_cubes += world::Cube::SUB_CUBES;
+            break;
+        default:
+            break;
+        }
+    }
+}
+} // namespace
+
+OctreeIndex::OctreeIndex(const ByteStream &stream, std::shared_ptr<world::Cube> root, const std::uint32_t index_level)
+    : m_stream(stream), m_root(std::move(root)), m_index_level(index_level) {
+    assert(m_root != nullptr);
+    ByteStreamReader reader(stream);
+    switch (read_octree_header(reader)) {
+    case 0:
+        read_top_levels(reader, true);
+        break;
+    case 1:
+        m_index_level = reader.read<std::uint32_t>();
+        read_top_levels(reader, false);
+        read_offsets(reader);
+        break;
+    default:
+        throw std::runtime_error("Unsupported octree version.");
+    }
+}
+
+void OctreeIndex::read_top_levels(ByteStreamReader &reader, const bool interleaved) {
+    if (m_index_level > MAX_INDEX_LEVEL) {
+        throw std::runtime_error("Index level is too deep.");
+    }
+    const std::size_t root_level = m_root->grid_level();
+    world::traverse_octree(
+        *m_root,
+        [&](world::Cube &cube) {
+            if (cube.grid_level() - root_level < m_index_level) {
+                deserialize_cube(reader, cube);
+                return true;
+            }
+            cube.apply_type(world::Cube::Type::EMPTY);
+            Subtree subtree{cube.shared_from_this()};
+            if (interleaved) {
+                subtree.offset = reader_position(m_stream, reader);
+                skip_subtree(reader);
+                subtree.size = reader_position(m_stream, reader) - subtree.offset;
+            }
+            m_subtrees.push_back(std::move(subtree));
+            return false;
+        },
+        [](world::Cube &) {});
+    // The records are applied without invalidating anything, see deserialize_cube.
+    m_root->mark_subtree_dirty();
+    m_root->mark_neighbours_dirty();
+}
+
+void OctreeIndex::read_offsets(ByteStreamReader &reader) {
+    if (reader.read<std::uint32_t>() != m_subtrees.size()) {
+        throw std::runtime_error("Mismatched number of subtrees.");
+    }
+    // The offsets are relative to the first subtree, which follows right after them.
+    const std::size_t offsets_size = (m_subtrees.size() + 1) * sizeof(std::uint64_t);
+    reader.require(offsets_size);
+    const std::size_t first_subtree = reader_position(m_stream, reader) + offsets_size;
+    const std::size_t subtrees_size = reader.remaining() - offsets_size;
+
+    auto offset = static_cast<std::size_t>(reader.read<std::uint64_t>());
+    for (auto &subtree : m_subtrees) {
+        const auto end = static_cast<std::size_t>(reader.read<std::uint64_t>());
+        if (end < offset || end > subtrees_size) {
+            throw std::runtime_error("Subtree offset is out of range.");
+        }
+        subtree.offset = first_subtree + offset;
+        subtree.size = end - offset;
+        offset = end;
+    }
+}
+
+const std::shared_ptr<world::Cube> &OctreeIndex::root() const noexcept {
+    return m_root;
+}
+
+std::uint32_t OctreeIndex::index_level() const noexcept {
+    return m_index_level;
+}
+
+std::size_t OctreeIndex::subtree_count() const noexcept {
+    return m_subtrees.size();
+}
+
+const std::shared_ptr<world::Cube> &OctreeIndex::subtree(const std::size_t idx) const {
+    return m_subtrees.at(idx).cube;
+}
+
+std::size_t OctreeIndex::subtree_size(const std::size_t idx) const {
+    return m_subtrees.at(idx).size;
+}
+
+bool OctreeIndex::is_loaded(const std::size_t idx) const {
+    return m_subtrees.at(idx).loaded;
+}
+
+void OctreeIndex::read_subtree(const std::size_t idx, world::Cube &cube) const {
+    const auto &subtree = m_subtrees.at(idx);
+    ByteStreamReader reader(m_stream, subtree.offset, subtree.size);
+    world::visit_pre_order(cube, [&reader](world::Cube &cube) { deserialize_cube(reader, cube); });
+    if (reader.remaining() != 0) {
+        throw std::runtime_error("Mismatched subtree size.");
+    }
+}
+
+void OctreeIndex::load_subtree_into(const std::size_t idx, world::Cube &cube) const {
+    const auto invalidate = [&cube] {
+        cube.mark_subtree_dirty();
+        cube.mark_neighbours_dirty();
+    };
+    try {
+        read_subtree(idx, cube);
+    } catch (...) {
+        invalidate();
+        throw;
+    }
+    invalidate();
+}
+
+void OctreeIndex::load_subtree(const std::size_t idx) {
+    if (m_subtrees.at(idx).loaded) {
+        return;
+    }
+    load_subtree_into(idx, *m_subtrees[idx].cube);
+    m_subtrees[idx].loaded = true;
+}
+
+void OctreeIndex::load_subtrees(const std::vector<std::size_t> &indices, tools::ThreadPool &thread_pool) {
+    std::vector<std::size_t> pending;
+    std::vector<bool> is_pending(m_subtrees.size(), false);
+    for (const std::size_t idx : indices) {
+        if (!m_subtrees.at(idx).loaded && !is_pending[idx]) {
+            pending.push_back(idx);
+            is_pending[idx] = true;
+        }
+    }
+
+    // Reading records only touches the cubes of the subtree, so the subtrees are read into the octree at the same
+    // time. Invalidating them reaches into the ancestors and the neighbours, which is done one after another.
+    std::vector<char> finished(pending.size(), 0);
+    std::exception_ptr error;
+    try {
+        thread_pool.parallel_for(pending.size(), [&](const std::size_t job) {
+            read_subtree(pending[job], *m_subtrees[pending[job]].cube);
+            finished[job] = 1;
+        });
+    } catch (...) {
+        // The subtrees which have been read are completed nevertheless.
+        error = std::current_exception();
+    }
+    for (std::size_t job = 0; job < pending.size(); job++) {
+        auto &subtree = m_subtrees[pending[job]];
+        subtree.cube->mark_subtree_dirty();
+        subtree.cube->mark_neighbours_dirty();
+        subtree.loaded = finished[job] != 0;
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+std::size_t OctreeIndex::load_region(const glm::vec3 &min, const glm::vec3 &max) {
+    std::size_t loaded = 0;
+    for (std::size_t idx = 0; idx < m_subtrees.size(); idx++) {
+        const glm::vec3 position = m_subtrees[idx].cube->position();
+        const float size = m_subtrees[idx].cube->size();
+        bool overlaps = true;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            overlaps = overlaps && position[axis] < max[axis] && position[axis] + size > min[axis];
+        }
+        if (overlaps && !m_subtrees[idx].loaded) {
+            load_subtree(idx);
+            loaded++;
+        }
+    }
+    return loaded;
+}
+
+void OctreeIndex::load_all() {
+    for (std::size_t idx = 0; idx < m_subtrees.size(); idx++) {
+        load_subtree(idx);
+    }
+}
+
+void OctreeIndex::load_all(tools::ThreadPool &thread_pool) {
+    std::vector<std::size_t> indices(m_subtrees.size());
+    std::iota(indices.begin(), indices.end(), std::size_t(0));
+    load_subtrees(indices, thread_pool);
+}
+} // namespace inexor::vulkan_renderer::io
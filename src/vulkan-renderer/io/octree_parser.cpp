@@ -1,89 +1,604 @@
 #include "inexor/vulkan-renderer/io/octree_parser.hpp"
+#include "inexor/vulkan-renderer/io/byte_sink.hpp"
 #include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/compression.hpp"
+#include "inexor/vulkan-renderer/io/octree_index.hpp"
 #include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/flat_octree.hpp"
+#include "inexor/vulkan-renderer/world/octree_dag.hpp"
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
-#include <functional>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace inexor::vulkan_renderer::io {
+namespace {
+constexpr char IDENTIFIER[] = "Inexor Octree";
+constexpr std::size_t IDENTIFIER_SIZE = sizeof(IDENTIFIER) - 1;
+
+/// Write the records of a subtree in pre-order.
+void serialize_subtree(const world::Cube &cube, ByteStreamWriter &writer) {
+    world::visit_pre_order(cube, [&writer](const world::Cube &cube) {
+        writer.write(cube.type());
+        if (cube.type() == world::Cube::Type::NORMAL) {
+            writer.write(cube.indentations());
+        }
+    });
+}
+
+/// Types are bit-packed into two bits each, the first type is in the lowest bits of a byte.
+constexpr std::size_t TYPES_PER_BYTE = 4;
+
+/// Write the size of the compressed channel followed by its compressed bytes.
+void write_channel(ByteStreamWriter &writer, const std::vector<std::uint8_t> &bytes) {
+    const std::vector<std::uint8_t> compressed = compress(bytes);
+    writer.write(static_cast<std::uint64_t>(compressed.size()));
+    writer.write(tools::Span<const std::uint8_t>(compressed));
+}
+
+/// Read and decompress a channel.
+/// @param size The size of the decompressed channel.
+std::vector<std::uint8_t> read_channel(ByteStreamReader &reader, const std::size_t size) {
+    const auto compressed_size = reader.read<std::uint64_t>();
+    if (compressed_size > reader.remaining()) {
+        throw std::runtime_error("Channel exceeds the stream.");
+    }
+    return decompress(reader.read_span(static_cast<std::size_t>(compressed_size)), size);
+}
+
+/// Read the channels of version 2 and merge them into the records of version 0.
+std::vector<std::uint8_t> read_compressed_records(ByteStreamReader &reader) {
+    const auto cube_count = reader.read<std::uint64_t>();
+    const auto types_size = cube_count / TYPES_PER_BYTE + (cube_count % TYPES_PER_BYTE != 0 ? 1 : 0);
+    const std::vector<std::uint8_t> types = read_channel(reader, static_cast<std::size_t>(types_size));
+    const auto type = [&types](const std::size_t idx) {
+        return static_cast<std::uint8_t>((types[idx / TYPES_PER_BYTE] >> (idx % TYPES_PER_BYTE * 2)) & 3U);
+    };
+    std::size_t normal_count = 0;
+    for (std::size_t idx = 0; idx < cube_count; idx++) {
+        normal_count += type(idx) == static_cast<std::uint8_t>(world::Cube::Type::NORMAL) ? 1 : 0;
+    }
+    const std::vector<std::uint8_t> indentations =
+        read_channel(reader, normal_count * world::Indentation::PACKED_EDGES_SIZE);
+
+    // The channels are merged into the records of version 0, creating the cubes costs far more than the copy.
+    std::vector<std::uint8_t> records;
+    records.reserve(static_cast<std::size_t>(cube_count) + indentations.size());
+    auto indentation = indentations.begin();
+    for (std::size_t idx = 0; idx < cube_count; idx++) {
+        records.push_back(type(idx));
+        if (records.back() == static_cast<std::uint8_t>(world::Cube::Type::NORMAL)) {
+            records.insert(records.end(), indentation, indentation + world::Indentation::PACKED_EDGES_SIZE);
+            indentation += world::Indentation::PACKED_EDGES_SIZE;
+        }
+    }
+    return records;
+}
+
+/// Record of version 3 which refers to an earlier subtree, followed by its index as std::uint32_t.
+constexpr std::uint8_t REFERENCE_RECORD = 4;
+/// Limit of the cubes an octree of version 3 may expand into, see MAX_EXPANDED_OCTREE_MEMORY.
+constexpr std::uint64_t MAX_EXPANDED_CUBES = MAX_EXPANDED_OCTREE_MEMORY / sizeof(world::Cube);
+
+/// Read the records of version 3 into a snapshot, identical subtrees share one node.
+/// @exception std::runtime_error The octree expands into more than MAX_EXPANDED_CUBES cubes.
+world::OctreeSnapshot read_deduplicated_records(ByteStreamReader &reader, const float size,
+                                                const glm::vec3 &position) {
+    struct Subtree {
+        std::shared_ptr<const world::SnapshotNode> node;
+        /// Number of cubes of the expanded subtree.
+        std::uint64_t cube_count;
+    };
+    struct PendingOctant {
+        world::SnapshotNode node;
+        std::size_t index;
+        std::size_t child_count;
+        std::uint64_t cube_count;
+    };
+
+    world::OctreeDag dag;
+    // Nodes by their index, octants are empty until all of their children have been read.
+    std::vector<Subtree> subtrees;
+    std::vector<PendingOctant> pending;
+    std::shared_ptr<const world::SnapshotNode> root;
+
+    // Add a complete node to its parent, which completes the parent after its last child.
+    const auto attach = [&](std::shared_ptr<const world::SnapshotNode> node, std::uint64_t cube_count) {
+        while (!pending.empty()) {
+            auto &parent = pending.back();
+            parent.node.childs[parent.child_count++] = std::move(node);
+            // Every count is within the limit, so the sum of an octant and its children can't overflow.
+            parent.cube_count += cube_count;
+            if (parent.cube_count > MAX_EXPANDED_CUBES) {
+                throw std::runtime_error("Octree expands into too many cubes.");
+            }
+            if (parent.child_count < world::Cube::SUB_CUBES) {
+                return;
+            }
+            node = dag.intern(std::move(parent.node));
+            cube_count = parent.cube_count;
+            subtrees[parent.index] = {node, cube_count};
+            pending.pop_back();
+        }
+        root = std::move(node);
+    };
+
+    while (root == nullptr) {
+        const auto record = reader.read<std::uint8_t>();
+        switch (record) {
+        case static_cast<std::uint8_t>(world::Cube::Type::EMPTY):
+        case static_cast<std::uint8_t>(world::Cube::Type::SOLID):
+            attach(dag.intern(world::SnapshotNode{static_cast<world::Cube::Type>(record)}), 1);
+            break;
+        case static_cast<std::uint8_t>(world::Cube::Type::NORMAL): {
+            const auto indentations = reader.read<std::array<world::Indentation, world::Cube::EDGES>>();
+            subtrees.push_back({dag.intern(world::SnapshotNode{world::Cube::Type::NORMAL, indentations}), 1});
+            attach(subtrees.back().node, 1);
+            break;
+        }
+        case static_cast<std::uint8_t>(world::Cube::Type::OCTANT):
+            subtrees.emplace_back();
+            pending.push_back({world::SnapshotNode{world::Cube::Type::OCTANT}, subtrees.size() - 1, 0, 1});
+            break;
+        case REFERENCE_RECORD: {
+            const auto index = reader.read<std::uint32_t>();
+            // Octants can't refer to themselves or to their ancestors.
+            if (index >= subtrees.size() || subtrees[index].node == nullptr) {
+                throw std::runtime_error("Invalid subtree reference.");
+            }
+            attach(subtrees[index].node, subtrees[index].cube_count);
+            break;
+        }
+        default:
+            throw std::runtime_error("Unknown record.");
+        }
+    }
+    return {size, position, std::move(root)};
+}
+
+/// Expand a snapshot into the records of version 0, a shared node is written for every cube which refers to it.
+std::vector<std::uint8_t> snapshot_records(const world::OctreeSnapshot &snapshot) {
+    std::vector<std::uint8_t> records;
+    std::vector<const world::SnapshotNode *> stack{snapshot.root().get()};
+    while (!stack.empty()) {
+        const world::SnapshotNode *node = stack.back();
+        stack.pop_back();
+        records.push_back(static_cast<std::uint8_t>(node->type));
+        if (node->type == world::Cube::Type::NORMAL) {
+            const auto bytes = world::Indentation::pack(node->indentations);
+            records.insert(records.end(), bytes.begin(), bytes.end());
+        }
+        // Reverse order, so the first child is written next.
+        for (std::size_t idx = world::Cube::SUB_CUBES; node->type == world::Cube::Type::OCTANT && idx-- > 0;) {
+            stack.push_back(node->childs[idx].get());
+        }
+    }
+    return records;
+}
+
+/// Read the record of a single cube into a node of a flat octree, see deserialize_cube.
+world::Cube::Type read_flat_cube(ByteStreamReader &reader, world::FlatOctree &octree, const world::NodeHandle node) {
+    const auto type = reader.read<std::uint8_t>();
+    if (type > static_cast<std::uint8_t>(world::Cube::Type::OCTANT)) {
+        throw std::runtime_error("Unknown record.");
+    }
+    octree.set_type(node, static_cast<world::Cube::Type>(type));
+    if (octree.type(node) == world::Cube::Type::NORMAL) {
+        std::array<std::uint8_t, world::Indentation::PACKED_EDGES_SIZE> bytes;
+        std::copy_n(reader.read_span(bytes.size()).begin(), bytes.size(), bytes.begin());
+        octree.set_indentations(node, world::Indentation::unpack(bytes));
+    }
+    return octree.type(node);
+}
+
+/// Read the records of a subtree in pre-order into a node of a flat octree.
+void read_flat_subtree(ByteStreamReader &reader, world::FlatOctree &octree, const world::NodeHandle node) {
+    std::vector<world::NodeHandle> handles{node};
+    while (!handles.empty()) {
+        const world::NodeHandle handle = handles.back();
+        handles.pop_back();
+        if (read_flat_cube(reader, octree, handle) == world::Cube::Type::OCTANT) {
+            // Reverse order, so the first child is read next.
+            for (std::size_t idx = world::Cube::SUB_CUBES; idx-- > 0;) {
+                handles.push_back(octree.child(handle, idx));
+            }
+        }
+    }
+}
+
+/// Read version 1 into a flat octree. The subtrees follow their offsets in the order of the index, so they are read
+/// one after another and only their sizes are checked against the offsets.
+void read_flat_indexed_records(ByteStreamReader &reader, world::FlatOctree &octree) {
+    const auto index_level = reader.read<std::uint32_t>();
+    std::vector<world::NodeHandle> subtrees;
+    std::vector<std::pair<world::NodeHandle, std::uint32_t>> handles{{world::FlatOctree::ROOT, 0}};
+    while (!handles.empty()) {
+        const auto [handle, level] = handles.back();
+        handles.pop_back();
+        if (level == index_level) {
+            subtrees.push_back(handle);
+            continue;
+        }
+        if (read_flat_cube(reader, octree, handle) == world::Cube::Type::OCTANT) {
+            for (std::size_t idx = world::Cube::SUB_CUBES; idx-- > 0;) {
+                handles.emplace_back(octree.child(handle, idx), level + 1);
+            }
+        }
+    }
+
+    if (reader.read<std::uint32_t>() != subtrees.size()) {
+        throw std::runtime_error("Mismatched number of subtrees.");
+    }
+    std::vector<std::uint64_t> offsets(subtrees.size() + 1);
+    for (auto &offset : offsets) {
+        offset = reader.read<std::uint64_t>();
+    }
+    const std::size_t subtrees_size = reader.remaining();
+    for (std::size_t idx = 0; idx < subtrees.size(); idx++) {
+        if (subtrees_size - reader.remaining() != offsets[idx]) {
+            throw std::runtime_error("Subtree offset is out of range.");
+        }
+        read_flat_subtree(reader, octree, subtrees[idx]);
+    }
+    if (subtrees_size - reader.remaining() != offsets.back()) {
+        throw std::runtime_error("Subtree offset is out of range.");
+    }
+}
+
+/// Read the records of version 0 which have been restored from another version into a flat octree.
+void read_flat_records(std::vector<std::uint8_t> records, world::FlatOctree &octree) {
+    const ByteStream record_stream(std::move(records));
+    ByteStreamReader record_reader(record_stream);
+    read_flat_subtree(record_reader, octree, world::FlatOctree::ROOT);
+    if (record_reader.remaining() != 0) {
+        throw std::runtime_error("Mismatched number of cubes.");
+    }
+}
+
+/// Size of the records of a subtree in bytes.
+std::size_t subtree_size(const world::Cube &cube) {
+    std::size_t size = 0;
+    world::visit_pre_order(cube, [&size](const world::Cube &cube) {
+        size += cube.type() == world::Cube::Type::NORMAL ? 1 + world::Indentation::PACKED_EDGES_SIZE : 1;
+    });
+    return size;
+}
+} // namespace
+
+std::uint32_t read_octree_header(ByteStreamReader &reader) {
+    const auto identifier = reader.read_span(IDENTIFIER_SIZE);
+    if (std::memcmp(identifier.data(), IDENTIFIER, IDENTIFIER_SIZE) != 0) {
+        throw std::runtime_error("Wrong identifier.");
+    }
+    return reader.read<std::uint32_t>();
+}
+
+void deserialize_cube(ByteStreamReader &reader, world::Cube &cube) {
+    // As long as the largest record fits into the rest of the stream, the end is checked only once per record.
+    constexpr std::size_t MAX_RECORD_SIZE = 1 + world::Indentation::PACKED_EDGES_SIZE;
+    const bool near_end = reader.remaining() < MAX_RECORD_SIZE;
+    if (near_end) {
+        reader.require(1);
+    }
+    // Loading replaces whole subtrees, which are invalidated at once afterwards.
+    cube.apply_type(static_cast<world::Cube::Type>(reader.read_byte_unchecked()));
+    if (cube.type() == world::Cube::Type::NORMAL) {
+        if (near_end) {
+            reader.require(world::Indentation::PACKED_EDGES_SIZE);
+        }
+        std::array<std::uint8_t, world::Indentation::PACKED_EDGES_SIZE> bytes;
+        std::copy_n(reader.read_span_unchecked(bytes.size()).begin(), bytes.size(), bytes.begin());
+        cube.m_indentations = world::Indentation::unpack(bytes);
+    }
+}
+
+void deserialize_subtree(ByteStreamReader &reader, world::Cube &cube) {
+    const auto invalidate = [&cube] {
+        cube.mark_subtree_dirty();
+        cube.mark_neighbours_dirty();
+    };
+    try {
+        // The type is read before the children are visited, so octants have their children already.
+        world::visit_pre_order(cube, [&reader](world::Cube &cube) { deserialize_cube(reader, cube); });
+    } catch (...) {
+        // The records which have been read changed the subtree already.
+        invalidate();
+        throw;
+    }
+    invalidate();
+}
+
 template <>
-ByteStream serialize_octree_impl<0>(const std::shared_ptr<const world::Cube> cube) {
+void serialize_octree_impl<0>(const std::shared_ptr<const world::Cube> cube, ByteStreamWriter &writer,
+                              const OctreeFormatSettings &) {
     if (cube == nullptr) {
         throw std::runtime_error("cube cannot be a nullptr.");
     }
-    ByteStreamWriter writer;
-    writer.write<std::string>("Inexor Octree");
+    writer.write<std::string>(IDENTIFIER);
     writer.write<std::uint32_t>(0);
+    serialize_subtree(*cube, writer);
+}
+
+template <>
+std::shared_ptr<world::Cube> deserialize_octree_impl<0>(const ByteStream &stream, std::shared_ptr<world::Cube> root) {
+    ByteStreamReader reader(stream);
+    if (read_octree_header(reader) != 0) {
+        throw std::runtime_error("Mismatched version.");
+    }
+    deserialize_subtree(reader, *root);
+    return root;
+}
+
+/// Version 1 splits the octree at the index level, so the subtrees on that level can be read independently:
+/// identifier, version, index level, the records of the cubes above the index level in pre-order, the number of
+/// subtrees, the offset of every subtree relative to the first one followed by the end of the last one, and finally
+/// the records of every subtree in pre-order. Offsets are std::uint64_t, everything else uses the records of version 0.
+template <>
+void serialize_octree_impl<1>(const std::shared_ptr<const world::Cube> cube, ByteStreamWriter &writer,
+                              const OctreeFormatSettings &settings) {
+    if (cube == nullptr) {
+        throw std::runtime_error("cube cannot be a nullptr.");
+    }
+    writer.write<std::string>(IDENTIFIER);
+    writer.write<std::uint32_t>(1);
+    writer.write<std::uint32_t>(settings.index_level);
 
-    std::function<void(const std::shared_ptr<const world::Cube> &)> iter_func;
-    // pre-order traversal
-    iter_func = [&iter_func, &writer](const std::shared_ptr<const world::Cube> &cube) {
-        writer.write(cube->type());
-        if (cube->type() == world::Cube::Type::OCTANT) {
-            for (const auto &child : cube->childs()) {
-                iter_func(child);
+    std::vector<const world::Cube *> subtrees;
+    world::traverse_octree(
+        *cube,
+        [&](const world::Cube &child) {
+            if (child.grid_level() - cube->grid_level() == settings.index_level) {
+                subtrees.push_back(&child);
+                return false;
             }
-            return;
+            writer.write(child.type());
+            if (child.type() == world::Cube::Type::NORMAL) {
+                writer.write(child.indentations());
+            }
+            return true;
+        },
+        [](const world::Cube &) {});
+
+    // The sizes are counted beforehand, so the offsets can be written in front of the subtrees into a sink.
+    writer.write(static_cast<std::uint32_t>(subtrees.size()));
+    std::uint64_t offset = 0;
+    writer.write(offset);
+    for (const auto *subtree : subtrees) {
+        offset += subtree_size(*subtree);
+        writer.write(offset);
+    }
+    for (const auto *subtree : subtrees) {
+        serialize_subtree(*subtree, writer);
+    }
+}
+
+template <>
+std::shared_ptr<world::Cube> deserialize_octree_impl<1>(const ByteStream &stream, std::shared_ptr<world::Cube> root) {
+    OctreeIndex index(stream, root);
+    index.load_all();
+    return root;
+}
+
+/// Version 2 compresses the records of version 0. They are split into a channel of bit-packed types and a channel of
+/// the packed indentations of the Type::NORMAL cubes, both in pre-order. Each channel is compressed on its own:
+/// identifier, version, number of cubes, compressed size of the types, compressed types, compressed size of the
+/// indentations and the compressed indentations.
+template <>
+void serialize_octree_impl<2>(const std::shared_ptr<const world::Cube> cube, ByteStreamWriter &writer,
+                              const OctreeFormatSettings &) {
+    if (cube == nullptr) {
+        throw std::runtime_error("cube cannot be a nullptr.");
+    }
+    writer.write<std::string>(IDENTIFIER);
+    writer.write<std::uint32_t>(2);
+
+    std::uint64_t cube_count = 0;
+    std::vector<std::uint8_t> types;
+    std::vector<std::uint8_t> indentations;
+    world::visit_pre_order(*cube, [&](const world::Cube &cube) {
+        const auto shift = static_cast<std::uint32_t>(cube_count % TYPES_PER_BYTE) * 2;
+        if (shift == 0) {
+            types.push_back(0);
         }
-        if (cube->type() == world::Cube::Type::NORMAL) {
-            writer.write(cube->indentations());
+        types.back() |= static_cast<std::uint8_t>(static_cast<std::uint8_t>(cube.type()) << shift);
+        cube_count++;
+        if (cube.type() == world::Cube::Type::NORMAL) {
+            const auto bytes = world::Indentation::pack(cube.indentations());
+            indentations.insert(indentations.end(), bytes.begin(), bytes.end());
         }
-    };
-
-    iter_func(cube);
-    return writer;
-};
+    });
+    writer.write(cube_count);
+    write_channel(writer, types);
+    write_channel(writer, indentations);
+}
 
 template <>
-std::shared_ptr<world::Cube> deserialize_octree_impl<0>(const ByteStream &stream) {
+std::shared_ptr<world::Cube> deserialize_octree_impl<2>(const ByteStream &stream, std::shared_ptr<world::Cube> root) {
     ByteStreamReader reader(stream);
-    if (reader.read<std::string>(std::size_t(13)) != "Inexor Octree") {
-        throw std::runtime_error("Wrong identifier.");
-    }
-    if (reader.read<std::uint32_t>() != 0) {
+    if (read_octree_header(reader) != 2) {
         throw std::runtime_error("Mismatched version.");
     }
-    std::shared_ptr<world::Cube> root = std::make_shared<world::Cube>();
+    const ByteStream record_stream(read_compressed_records(reader));
+    ByteStreamReader record_reader(record_stream);
+    deserialize_subtree(record_reader, *root);
+    if (record_reader.remaining() != 0) {
+        throw std::runtime_error("Mismatched number of cubes.");
+    }
+    return root;
+}
 
-    std::function<void(std::shared_ptr<world::Cube> &)> iter_func;
-    // pre-order traversal
-    iter_func = [&iter_func, &reader](std::shared_ptr<world::Cube> &cube) {
-        cube->set_type(reader.read<world::Cube::Type>());
-        if (cube->type() == world::Cube::Type::OCTANT) {
-            for (auto child : cube->childs()) {
-                iter_func(child);
+/// Version 3 stores identical subtrees only once. It uses the records of version 0 in pre-order, but the record of every
+/// Type::NORMAL cube and octant gets the next index. Further copies of these subtrees are written as a reference record
+/// with the index of the first copy instead.
+template <>
+void serialize_octree_impl<3>(const std::shared_ptr<const world::Cube> cube, ByteStreamWriter &writer,
+                              const OctreeFormatSettings &) {
+    if (cube == nullptr) {
+        throw std::runtime_error("cube cannot be a nullptr.");
+    }
+    writer.write<std::string>(IDENTIFIER);
+    writer.write<std::uint32_t>(3);
+
+    world::OctreeDag dag;
+    const world::OctreeSnapshot snapshot = dag.deduplicate(cube->snapshot());
+    std::unordered_map<const world::SnapshotNode *, std::uint32_t> indices;
+    std::vector<const world::SnapshotNode *> stack{snapshot.root().get()};
+    while (!stack.empty()) {
+        const world::SnapshotNode *node = stack.back();
+        stack.pop_back();
+        if (node->type == world::Cube::Type::NORMAL || node->type == world::Cube::Type::OCTANT) {
+            const auto [iter, inserted] = indices.emplace(node, static_cast<std::uint32_t>(indices.size()));
+            if (!inserted) {
+                writer.write(REFERENCE_RECORD);
+                writer.write(iter->second);
+                continue;
             }
-            return;
         }
-        if (cube->type() == world::Cube::Type::NORMAL) {
-            cube->m_indentations = reader.read<std::array<world::Indentation, world::Cube::EDGES>>();
+        writer.write(node->type);
+        if (node->type == world::Cube::Type::NORMAL) {
+            writer.write(node->indentations);
         }
-    };
-    iter_func(root);
+        // Reverse order, so the first child is written next.
+        for (std::size_t idx = world::Cube::SUB_CUBES; node->type == world::Cube::Type::OCTANT && idx-- > 0;) {
+            stack.push_back(node->childs[idx].get());
+        }
+    }
+}
+
+template <>
+std::shared_ptr<world::Cube> deserialize_octree_impl<3>(const ByteStream &stream, std::shared_ptr<world::Cube> root) {
+    ByteStreamReader reader(stream);
+    if (read_octree_header(reader) != 3) {
+        throw std::runtime_error("Mismatched version.");
+    }
+    const world::OctreeSnapshot snapshot = read_deduplicated_records(reader, root->size(), root->position());
+    const ByteStream record_stream(snapshot_records(snapshot));
+    ByteStreamReader record_reader(record_stream);
+    deserialize_subtree(record_reader, *root);
+    // The cubes are identical to the snapshot, so restoring it only shares its nodes. Later snapshots of the octree are
+    // deduplicated as well.
+    root->restore(snapshot);
     return root;
 }
 
-ByteStream serialize_octree(const std::shared_ptr<const world::Cube> cube, const std::uint32_t version) {
+namespace {
+/// Serialize the octree in the given version into the writer.
+void serialize_octree_into(const std::shared_ptr<const world::Cube> &cube, ByteStreamWriter &writer,
+                           const std::uint32_t version, const OctreeFormatSettings &settings) {
     switch (version) {
     case 0:
-        return serialize_octree_impl<0>(cube);
+        serialize_octree_impl<0>(cube, writer, settings);
+        break;
+    case 1:
+        serialize_octree_impl<1>(cube, writer, settings);
+        break;
+    case 2:
+        serialize_octree_impl<2>(cube, writer, settings);
+        break;
+    case 3:
+        serialize_octree_impl<3>(cube, writer, settings);
+        break;
     default:
         throw std::runtime_error("Unsupported octree version.");
     };
 }
 
+/// Read the version of the stream and deserialize it into the root cube.
+std::shared_ptr<world::Cube> deserialize_octree_into(const ByteStream &stream, std::shared_ptr<world::Cube> root) {
+    ByteStreamReader reader(stream);
+    switch (read_octree_header(reader)) {
+    case 0:
+        return deserialize_octree_impl<0>(stream, std::move(root));
+    case 1:
+        return deserialize_octree_impl<1>(stream, std::move(root));
+    case 2:
+        return deserialize_octree_impl<2>(stream, std::move(root));
+    case 3:
+        return deserialize_octree_impl<3>(stream, std::move(root));
+    default:
+        throw std::runtime_error("Unsupported octree version.");
+    };
+}
+} // namespace
+
+ByteStream serialize_octree(const std::shared_ptr<const world::Cube> cube, const std::uint32_t version,
+                            const OctreeFormatSettings &settings) {
+    ByteStreamWriter writer;
+    serialize_octree_into(cube, writer, version, settings);
+    // Only the buffer is moved out of the writer.
+    return std::move(writer);
+}
+
+void serialize_octree(const std::shared_ptr<const world::Cube> cube, ByteSink &sink, const std::uint32_t version,
+                      const OctreeFormatSettings &settings) {
+    ByteStreamWriter writer(sink);
+    serialize_octree_into(cube, writer, version, settings);
+    writer.finish();
+}
+
+void save_octree(const std::shared_ptr<const world::Cube> cube, const std::filesystem::path &path,
+                 const std::uint32_t version, const OctreeFormatSettings &settings) {
+    FileSink sink(path);
+    serialize_octree(cube, sink, version, settings);
+}
+
 std::shared_ptr<world::Cube> deserialize_octree(const ByteStream &stream) {
+    return deserialize_octree_into(stream, std::make_shared<world::Cube>());
+}
+
+std::shared_ptr<world::Cube> deserialize_octree(const ByteStream &stream, const float size,
+                                                const glm::vec3 &position) {
+    return deserialize_octree_into(stream, std::make_shared<world::Cube>(world::Cube::Type::SOLID, size, position));
+}
+
+std::shared_ptr<world::Cube> deserialize_octree(const ByteStream &stream, tools::ThreadPool &thread_pool) {
     ByteStreamReader reader(stream);
-    if (reader.read<std::string>(std::size_t(13)) != "Inexor Octree") {
-        throw std::runtime_error("Wrong identifier.");
+    // The subtrees of the compressed and the deduplicated version can't be found without reading the whole octree.
+    const std::uint32_t version = read_octree_header(reader);
+    if (version == 2 || version == 3) {
+        return deserialize_octree(stream);
     }
-    const std::uint32_t version = reader.read<std::uint32_t>();
-    switch (version) {
+    OctreeIndex index(stream, std::make_shared<world::Cube>());
+    index.load_all(thread_pool);
+    return index.root();
+}
+
+world::OctreeSnapshot deserialize_octree_snapshot(const ByteStream &stream) {
+    ByteStreamReader reader(stream);
+    if (read_octree_header(reader) != 3) {
+        world::OctreeDag dag;
+        return dag.deduplicate(deserialize_octree(stream)->snapshot());
+    }
+    // Same size and position as the root cube of the other versions.
+    const world::Cube root;
+    return read_deduplicated_records(reader, root.size(), root.position());
+}
+
+world::FlatOctree deserialize_flat_octree(const ByteStream &stream) {
+    ByteStreamReader reader(stream);
+    world::FlatOctree octree;
+    switch (read_octree_header(reader)) {
     case 0:
-        return deserialize_octree_impl<0>(stream);
+        read_flat_subtree(reader, octree, world::FlatOctree::ROOT);
+        break;
+    case 1:
+        read_flat_indexed_records(reader, octree);
+        break;
+    case 2:
+        read_flat_records(read_compressed_records(reader), octree);
+        break;
+    case 3:
+        read_flat_records(snapshot_records(read_deduplicated_records(reader, octree.size(), octree.position())),
+                          octree);
+        break;
     default:
         throw std::runtime_error("Unsupported octree version.");
-    };
+    }
+    return octree;
 }
 } // namespace inexor::vulkan_renderer::io
@@ -10,8 +10,7 @@
 #include <array>
 #include <cassert>
 #include <fstream>
-#include <limits>
-#include <unordered_map>
+#include <numeric>
 
 namespace inexor::vulkan_renderer {
 
@@ -33,6 +32,7 @@ void VulkanRenderer::setup_frame_graph() {
     vertex_buffer.add_vertex_attribute(VK_FORMAT_R32G32B32_SFLOAT, offsetof(OctreeGpuVertex, position));
     vertex_buffer.add_vertex_attribute(VK_FORMAT_R32G32B32_SFLOAT, offsetof(OctreeGpuVertex, color));
     vertex_buffer.upload_data(m_octree_vertices);
+    m_octree_vertex_buffer = &vertex_buffer;
 
     auto &main_stage = m_frame_graph->add<GraphicsStage>("main stage");
     main_stage.writes_to(back_buffer);
@@ -55,20 +55,31 @@ void VulkanRenderer::setup_frame_graph() {
 }
 
 void VulkanRenderer::generate_octree_indices() {
-    auto old_vertices = std::move(m_octree_vertices);
-    std::unordered_map<OctreeGpuVertex, std::uint16_t> vertex_map;
-    for (auto &vertex : old_vertices) {
-        // TODO: Use std::unordered_map::contains() when we switch to C++ 20.
-        if (vertex_map.count(vertex) == 0) {
-            assert(vertex_map.size() < std::numeric_limits<std::uint16_t>::max() && "Octree too big!");
-            vertex_map.emplace(vertex, static_cast<std::uint16_t>(vertex_map.size()));
-            m_octree_vertices.push_back(vertex);
-        }
-        m_octree_indices.push_back(vertex_map.at(vertex));
-    }
+    const auto old_vertices = std::move(m_octree_vertices);
+    m_vertex_welder.weld(old_vertices, m_octree_vertices, m_octree_indices);
     spdlog::trace("Reduced octree by {} vertices", old_vertices.size() - m_octree_vertices.size());
 }
 
+void VulkanRenderer::generate_octree_identity_indices() {
+    m_octree_indices.resize(m_octree_vertices.size());
+    std::iota(m_octree_indices.begin(), m_octree_indices.end(), 0);
+}
+
+void VulkanRenderer::update_octree_vertices(const std::size_t first, const std::size_t count) {
+    assert(first + count <= m_octree_vertices.size());
+    assert(m_octree_vertex_buffer != nullptr);
+    m_frame_graph->update_buffer(*m_octree_vertex_buffer, first * sizeof(OctreeGpuVertex), &m_octree_vertices[first],
+                                 count * sizeof(OctreeGpuVertex));
+}
+
+void VulkanRenderer::recreate_frame_graph() {
+    vkDeviceWaitIdle(m_device->device());
+
+    m_frame_graph.reset();
+    m_frame_graph = std::make_unique<FrameGraph>(*m_device, m_command_pool->get(), *m_swapchain);
+    setup_frame_graph();
+}
+
 void VulkanRenderer::recreate_swapchain() {
     m_window->wait_for_focus();
     vkDeviceWaitIdle(m_device->device());
@@ -76,8 +87,7 @@ void VulkanRenderer::recreate_swapchain() {
     // TODO(): This is quite naive, we don't need to recompile the whole frame graph on swapchain invalidation
     m_frame_graph.reset();
     m_swapchain->recreate(m_window->width(), m_window->height());
-    m_frame_graph = std::make_unique<FrameGraph>(*m_device, m_command_pool->get(), *m_swapchain);
-    setup_frame_graph();
+    recreate_frame_graph();
 
     m_image_available_semaphore.reset();
     m_rendering_finished_semaphore.reset();
@@ -0,0 +1,110 @@
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace inexor::vulkan_renderer::tools {
+
+namespace {
+/// Index of the worker queue of the current thread, or ``NO_WORKER`` if it is not a worker thread.
+constexpr std::size_t NO_WORKER = static_cast<std::size_t>(-1);
+thread_local const ThreadPool *current_pool{nullptr};
+thread_local std::size_t current_worker{NO_WORKER};
+} // namespace
+
+ThreadPool::ThreadPool(std::size_t worker_count) {
+    if (worker_count == 0) {
+        worker_count = std::max(1U, std::thread::hardware_concurrency());
+    }
+    m_queues.reserve(worker_count);
+    for (std::size_t index = 0; index < worker_count; index++) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    m_workers.reserve(worker_count);
+    for (std::size_t index = 0; index < worker_count; index++) {
+        m_workers.emplace_back(&ThreadPool::worker_loop, this, index);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(m_sleep_mutex);
+        m_stop = true;
+    }
+    m_wakeup.notify_all();
+    for (auto &worker : m_workers) {
+        worker.join();
+    }
+}
+
+std::optional<ThreadPool::Job> ThreadPool::take_job(const std::size_t queue_index) {
+    {
+        // The own queue is used like a stack, as the newest jobs are the most likely to be in the cache.
+        WorkerQueue &queue = *m_queues[queue_index];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            Job job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            m_queued_jobs.fetch_sub(1);
+            return job;
+        }
+    }
+    for (std::size_t offset = 1; offset < m_queues.size(); offset++) {
+        // Steal the oldest job, which usually represents the largest amount of work.
+        WorkerQueue &queue = *m_queues[(queue_index + offset) % m_queues.size()];
+        std::lock_guard lock(queue.mutex);
+        if (!queue.jobs.empty()) {
+            Job job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            m_queued_jobs.fetch_sub(1);
+            return job;
+        }
+    }
+    return std::nullopt;
+}
+
+void ThreadPool::worker_loop(const std::size_t worker_index) {
+    current_pool = this;
+    current_worker = worker_index;
+    while (true) {
+        if (auto job = take_job(worker_index)) {
+            (*job)();
+            continue;
+        }
+        std::unique_lock lock(m_sleep_mutex);
+        m_wakeup.wait(lock, [&] { return m_stop || m_queued_jobs.load() > 0; });
+        if (m_stop && m_queued_jobs.load() == 0) {
+            return;
+        }
+    }
+}
+
+void ThreadPool::submit(Job job) {
+    const std::size_t queue_index =
+        current_pool == this ? current_worker : m_next_queue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+    {
+        // Increasing the counter under the lock makes sure a worker which is about to sleep sees the new job. It is
+        // increased before the job is queued, so it can't underflow if the job is taken immediately.
+        std::lock_guard lock(m_sleep_mutex);
+        m_queued_jobs.fetch_add(1);
+    }
+    {
+        WorkerQueue &queue = *m_queues[queue_index];
+        std::lock_guard lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+    m_wakeup.notify_one();
+}
+
+void ThreadPool::wait(const std::atomic<std::size_t> &pending_jobs) {
+    const std::size_t queue_index = current_pool == this ? current_worker : 0;
+    while (pending_jobs.load(std::memory_order_acquire) > 0) {
+        if (auto job = take_job(queue_index)) {
+            (*job)();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+} // namespace inexor::vulkan_renderer::tools
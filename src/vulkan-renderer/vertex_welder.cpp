@@ -0,0 +1,219 @@
+#include "inexor/vulkan-renderer/vertex_welder.hpp"
+
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace inexor::vulkan_renderer {
+namespace {
+// Vertices are hashed and compared by their bytes, so they must not contain any padding bytes.
+static_assert(std::is_trivially_copyable_v<OctreeGpuVertex> && sizeof(OctreeGpuVertex) == 3 * sizeof(std::uint64_t));
+
+constexpr std::uint64_t PRIME_1 = 0x9E3779B185EBCA87ULL;
+constexpr std::uint64_t PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+/// The parallel variant doesn't split the vertices into smaller blocks, as the jobs would cost more than they save.
+constexpr std::size_t MIN_BLOCK_SIZE = 16384;
+/// The parallel variant partitions the vertices by this many upper bits of their hash.
+constexpr unsigned PARTITION_BITS = 8;
+constexpr std::size_t PARTITION_COUNT = std::size_t(1) << PARTITION_BITS;
+
+std::uint64_t hash_vertex(const OctreeGpuVertex &vertex) noexcept {
+    std::array<std::uint64_t, 3> words;
+    std::memcpy(words.data(), &vertex, sizeof(vertex));
+    std::uint64_t hash = PRIME_1;
+    for (const auto word : words) {
+        hash = (hash ^ (word * PRIME_2)) * PRIME_1;
+        hash ^= hash >> 29U;
+    }
+    // Final mix of MurmurHash3, so every byte of the vertex affects the lower bits which select the slot.
+    hash ^= hash >> 33U;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33U;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33U;
+    return hash;
+}
+
+bool equal_bytes(const OctreeGpuVertex &lhs, const OctreeGpuVertex &rhs) noexcept {
+    return std::memcmp(&lhs, &rhs, sizeof(OctreeGpuVertex)) == 0;
+}
+
+/// Number of slots of a table, the load factor is kept at one half at most, so probe sequences stay short.
+std::size_t slot_count(const std::size_t unique_vertices) noexcept {
+    std::size_t slots = 16;
+    while (slots < unique_vertices * 2) {
+        slots *= 2;
+    }
+    return slots;
+}
+
+[[noreturn]] void throw_too_many_vertices() {
+    throw std::runtime_error("Too many unique vertices for the index type.");
+}
+} // namespace
+
+void VertexWelder::reset_slots(const std::size_t unique_vertices) {
+    m_slots.assign(slot_count(unique_vertices), 0);
+}
+
+void VertexWelder::insert_slot(const OctreeGpuVertex &vertex, const std::uint32_t index) noexcept {
+    const std::size_t mask = m_slots.size() - 1;
+    std::size_t slot = hash_vertex(vertex) & mask;
+    while (m_slots[slot] != 0) {
+        slot = (slot + 1) & mask;
+    }
+    m_slots[slot] = index + 1;
+}
+
+template <typename Index>
+void VertexWelder::weld(const tools::Span<const OctreeGpuVertex> input, std::vector<OctreeGpuVertex> &vertices,
+                        std::vector<Index> &indices) {
+    const std::size_t max_vertices = std::numeric_limits<Index>::max();
+    vertices.clear();
+    indices.clear();
+    vertices.reserve(std::min(input.size(), max_vertices));
+    indices.reserve(input.size());
+    // Most vertices of a triangle list are shared by several triangles, the table grows if this is not the case.
+    reset_slots(std::min(input.size() / 2, max_vertices));
+
+    std::size_t mask = m_slots.size() - 1;
+    for (const auto &vertex : input) {
+        std::size_t slot = hash_vertex(vertex) & mask;
+        while (m_slots[slot] != 0 && !equal_bytes(vertices[m_slots[slot] - 1], vertex)) {
+            slot = (slot + 1) & mask;
+        }
+        if (m_slots[slot] != 0) {
+            indices.push_back(static_cast<Index>(m_slots[slot] - 1));
+            continue;
+        }
+        if (vertices.size() == max_vertices) {
+            throw_too_many_vertices();
+        }
+        indices.push_back(static_cast<Index>(vertices.size()));
+        vertices.push_back(vertex);
+        m_slots[slot] = static_cast<std::uint32_t>(vertices.size());
+        if (vertices.size() * 2 > m_slots.size()) {
+            reset_slots(vertices.size() * 2);
+            mask = m_slots.size() - 1;
+            for (std::size_t idx = 0; idx < vertices.size(); idx++) {
+                insert_slot(vertices[idx], static_cast<std::uint32_t>(idx));
+            }
+        }
+    }
+}
+
+template <typename Index>
+void VertexWelder::weld(const tools::Span<const OctreeGpuVertex> input, std::vector<OctreeGpuVertex> &vertices,
+                        std::vector<Index> &indices, tools::ThreadPool &thread_pool) {
+    struct Entry {
+        std::uint64_t hash;
+        std::uint32_t index;
+    };
+
+    const std::size_t count = input.size();
+    if (count > std::numeric_limits<std::uint32_t>::max()) {
+        throw_too_many_vertices();
+    }
+    const std::size_t block_count =
+        std::clamp<std::size_t>(count / MIN_BLOCK_SIZE, 1, std::max<std::size_t>(thread_pool.worker_count(), 1) * 4);
+    const auto block_begin = [&](const std::size_t block) { return count * block / block_count; };
+
+    // Partition the vertices by the upper bits of their hash, which is a single pass of a radix sort. A partition keeps
+    // the order of the input. The offsets are ordered by partition and then by block.
+    const auto partition_of = [](const std::uint64_t hash) {
+        return static_cast<std::size_t>(hash >> (64U - PARTITION_BITS));
+    };
+    std::vector<std::size_t> offsets(PARTITION_COUNT * block_count, 0);
+    thread_pool.parallel_for(block_count, [&](const std::size_t block) {
+        for (std::size_t idx = block_begin(block); idx < block_begin(block + 1); idx++) {
+            offsets[partition_of(hash_vertex(input[idx])) * block_count + block]++;
+        }
+    });
+    std::size_t offset_sum = 0;
+    for (auto &offset : offsets) {
+        offset_sum += std::exchange(offset, offset_sum);
+    }
+    std::vector<Entry> entries(count);
+    thread_pool.parallel_for(block_count, [&](const std::size_t block) {
+        for (std::size_t idx = block_begin(block); idx < block_begin(block + 1); idx++) {
+            const std::uint64_t hash = hash_vertex(input[idx]);
+            entries[offsets[partition_of(hash) * block_count + block]++] = {hash, static_cast<std::uint32_t>(idx)};
+        }
+    });
+    // After the scatter, every offset is the end of its range.
+    const auto partition_begin = [&](const std::size_t partition) {
+        return partition == 0 ? 0 : offsets[partition * block_count - 1];
+    };
+    const auto group_begin = [&](const std::size_t group) { return PARTITION_COUNT * group / block_count; };
+
+    // Every partition is welded with a table of its own, the first vertex found is the first occurrence.
+    std::vector<std::uint32_t> first_occurrence(count);
+    thread_pool.parallel_for(block_count, [&](const std::size_t group) {
+        std::vector<std::uint32_t> table;
+        for (std::size_t partition = group_begin(group); partition < group_begin(group + 1); partition++) {
+            const std::size_t begin = partition_begin(partition);
+            const std::size_t end = partition_begin(partition + 1);
+            const std::size_t mask = slot_count(end - begin) - 1;
+            table.assign(mask + 1, 0);
+            for (std::size_t pos = begin; pos < end; pos++) {
+                const auto &entry = entries[pos];
+                std::size_t slot = entry.hash & mask;
+                while (table[slot] != 0 && (entries[table[slot] - 1].hash != entry.hash ||
+                                            !equal_bytes(input[entries[table[slot] - 1].index], input[entry.index]))) {
+                    slot = (slot + 1) & mask;
+                }
+                if (table[slot] == 0) {
+                    table[slot] = static_cast<std::uint32_t>(pos + 1);
+                }
+                first_occurrence[entry.index] = entries[table[slot] - 1].index;
+            }
+        }
+    });
+
+    // Number the first occurrences in the order of the input.
+    std::vector<std::size_t> block_offsets(block_count + 1, 0);
+    thread_pool.parallel_for(block_count, [&](const std::size_t block) {
+        for (std::size_t idx = block_begin(block); idx < block_begin(block + 1); idx++) {
+            block_offsets[block + 1] += first_occurrence[idx] == idx ? 1 : 0;
+        }
+    });
+    std::partial_sum(block_offsets.begin(), block_offsets.end(), block_offsets.begin());
+    if (block_offsets.back() > std::numeric_limits<Index>::max()) {
+        throw_too_many_vertices();
+    }
+
+    vertices.assign(block_offsets.back(), OctreeGpuVertex({}, {}));
+    indices.resize(count);
+    std::vector<std::uint32_t> unique_index(count);
+    thread_pool.parallel_for(block_count, [&](const std::size_t block) {
+        std::size_t next = block_offsets[block];
+        for (std::size_t idx = block_begin(block); idx < block_begin(block + 1); idx++) {
+            if (first_occurrence[idx] == idx) {
+                unique_index[idx] = static_cast<std::uint32_t>(next);
+                vertices[next++] = input[idx];
+            }
+        }
+    });
+    thread_pool.parallel_for(block_count, [&](const std::size_t block) {
+        for (std::size_t idx = block_begin(block); idx < block_begin(block + 1); idx++) {
+            indices[idx] = static_cast<Index>(unique_index[first_occurrence[idx]]);
+        }
+    });
+}
+
+template void VertexWelder::weld<std::uint16_t>(tools::Span<const OctreeGpuVertex>, std::vector<OctreeGpuVertex> &,
+                                                std::vector<std::uint16_t> &);
+template void VertexWelder::weld<std::uint32_t>(tools::Span<const OctreeGpuVertex>, std::vector<OctreeGpuVertex> &,
+                                                std::vector<std::uint32_t> &);
+template void VertexWelder::weld<std::uint16_t>(tools::Span<const OctreeGpuVertex>, std::vector<OctreeGpuVertex> &,
+                                                std::vector<std::uint16_t> &, tools::ThreadPool &);
+template void VertexWelder::weld<std::uint32_t>(tools::Span<const OctreeGpuVertex>, std::vector<OctreeGpuVertex> &,
+                                                std::vector<std::uint32_t> &, tools::ThreadPool &);
+} // namespace inexor::vulkan_renderer
@@ -0,0 +1,205 @@
+#include "inexor/vulkan-renderer/world/chunk_streamer.hpp"
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <glm/common.hpp>
+#include <glm/geometric.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <exception>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+std::size_t ChunkCoordinateHash::operator()(const ChunkCoordinate &coordinate) const noexcept {
+    // Multiplication by large primes spreads neighbouring chunks over the buckets.
+    return static_cast<std::size_t>(static_cast<std::uint32_t>(coordinate.x) * 73856093U) ^
+           static_cast<std::size_t>(static_cast<std::uint32_t>(coordinate.y) * 19349663U) ^
+           static_cast<std::size_t>(static_cast<std::uint32_t>(coordinate.z) * 83492791U);
+}
+
+std::chrono::microseconds ChunkStreamerMetrics::average_load_latency() const noexcept {
+    return loaded_chunks == 0 ? std::chrono::microseconds{0}
+                              : total_load_latency / static_cast<std::int64_t>(loaded_chunks);
+}
+
+ChunkStreamer::ChunkStreamer(tools::ThreadPool &thread_pool, ChunkLoader loader, const Settings &settings)
+    : m_thread_pool(thread_pool), m_settings(settings), m_load_queue(std::make_shared<LoadQueue>()) {
+    assert(settings.chunk_size > 0);
+    assert(settings.max_pending_loads > 0);
+    m_load_queue->loader = std::move(loader);
+}
+
+ChunkStreamer::ChunkLoader ChunkStreamer::directory_loader(std::filesystem::path directory) {
+    return [directory = std::move(directory)](const ChunkCoordinate &coordinate) -> std::optional<io::ByteStream> {
+        const auto path = directory / (std::to_string(coordinate.x) + "_" + std::to_string(coordinate.y) + "_" +
+                                       std::to_string(coordinate.z) + ".nxoc");
+        if (!std::filesystem::exists(path)) {
+            return std::nullopt;
+        }
+        return io::ByteStream(path);
+    };
+}
+
+ChunkStreamer::LoadResult ChunkStreamer::load_chunk(const ChunkLoader &loader, const ChunkCoordinate &coordinate,
+                                                    const Settings &settings) {
+    LoadResult result{coordinate, {}, {}};
+    try {
+        const auto stream = loader(coordinate);
+        if (!stream) {
+            return result;
+        }
+        auto root = io::deserialize_octree(*stream, settings.chunk_size, glm::vec3(coordinate) * settings.chunk_size);
+
+        // Meshing fills the polygon caches, so the main thread only has to collect them.
+        std::size_t polygon_count = 0;
+        for (const auto &cache : root->polygons(true)) {
+            polygon_count += cache.size();
+        }
+        std::size_t cube_count = 0;
+        visit_pre_order(*root, [&cube_count](const Cube &) { cube_count++; });
+
+        result.chunk.root = std::move(root);
+        result.chunk.cpu_memory = cube_count * sizeof(Cube);
+        result.chunk.gpu_memory = polygon_count * 3 * settings.vertex_size;
+    } catch (const std::exception &exception) {
+        result.error = exception.what();
+    }
+    return result;
+}
+
+bool ChunkStreamer::is_over_budget() const noexcept {
+    return m_metrics.cpu_memory > m_settings.cpu_memory_budget || m_metrics.gpu_memory > m_settings.gpu_memory_budget;
+}
+
+float ChunkStreamer::distance(const ChunkCoordinate &coordinate, const glm::vec3 &camera_position) const noexcept {
+    return glm::distance((glm::vec3(coordinate) + 0.5F) * m_settings.chunk_size, camera_position);
+}
+
+bool ChunkStreamer::collect_finished_loads() {
+    std::vector<LoadResult> finished;
+    {
+        std::lock_guard lock(m_load_queue->mutex);
+        finished.swap(m_load_queue->finished);
+    }
+
+    bool changed = false;
+    const auto now = std::chrono::steady_clock::now();
+    for (auto &result : finished) {
+        const auto request = m_pending_loads.find(result.coordinate);
+        assert(request != m_pending_loads.end());
+        const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(now - request->second);
+        m_pending_loads.erase(request);
+
+        m_metrics.loaded_chunks++;
+        m_metrics.last_load_latency = latency;
+        m_metrics.max_load_latency = std::max(m_metrics.max_load_latency, latency);
+        m_metrics.total_load_latency += latency;
+        if (!result.error.empty()) {
+            m_metrics.failed_loads++;
+            spdlog::error("Failed to load chunk ({}, {}, {}): {}", result.coordinate.x, result.coordinate.y,
+                          result.coordinate.z, result.error);
+        }
+
+        changed = changed || result.chunk.root != nullptr;
+        m_metrics.cpu_memory += result.chunk.cpu_memory;
+        m_metrics.gpu_memory += result.chunk.gpu_memory;
+        m_chunks.emplace(result.coordinate, std::move(result.chunk));
+    }
+    return changed;
+}
+
+bool ChunkStreamer::evict_chunks(const glm::vec3 &camera_position) {
+    std::vector<std::pair<float, ChunkCoordinate>> candidates;
+    for (auto iter = m_chunks.begin(); iter != m_chunks.end();) {
+        const float chunk_distance = distance(iter->first, camera_position);
+        if (chunk_distance <= m_settings.load_radius) {
+            ++iter;
+        } else if (iter->second.root == nullptr) {
+            iter = m_chunks.erase(iter);
+        } else {
+            candidates.emplace_back(chunk_distance, iter->first);
+            ++iter;
+        }
+    }
+    // The furthest chunks are at the back.
+    std::sort(candidates.begin(), candidates.end(),
+              [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+    bool changed = false;
+    while (is_over_budget() && !candidates.empty()) {
+        const auto iter = m_chunks.find(candidates.back().second);
+        candidates.pop_back();
+        m_metrics.cpu_memory -= iter->second.cpu_memory;
+        m_metrics.gpu_memory -= iter->second.gpu_memory;
+        m_metrics.evicted_chunks++;
+        m_chunks.erase(iter);
+        changed = true;
+    }
+    return changed;
+}
+
+void ChunkStreamer::request_chunks(const glm::vec3 &camera_position) {
+    if (m_pending_loads.size() >= m_settings.max_pending_loads) {
+        return;
+    }
+    // The center of a chunk within the load radius is at most one chunk further away than the radius.
+    const auto range = static_cast<int>(std::ceil(m_settings.load_radius / m_settings.chunk_size)) + 1;
+    const ChunkCoordinate camera_chunk(glm::floor(camera_position / m_settings.chunk_size));
+    std::vector<std::pair<float, ChunkCoordinate>> missing;
+    for (int x = -range; x <= range; x++) {
+        for (int y = -range; y <= range; y++) {
+            for (int z = -range; z <= range; z++) {
+                const ChunkCoordinate coordinate = camera_chunk + ChunkCoordinate{x, y, z};
+                const float chunk_distance = distance(coordinate, camera_position);
+                if (chunk_distance <= m_settings.load_radius && m_chunks.count(coordinate) == 0 &&
+                    m_pending_loads.count(coordinate) == 0) {
+                    missing.emplace_back(chunk_distance, coordinate);
+                }
+            }
+        }
+    }
+    std::sort(missing.begin(), missing.end(), [](const auto &lhs, const auto &rhs) { return lhs.first < rhs.first; });
+
+    const std::size_t request_count = std::min(missing.size(), m_settings.max_pending_loads - m_pending_loads.size());
+    const auto now = std::chrono::steady_clock::now();
+    for (std::size_t idx = 0; idx < request_count; idx++) {
+        const ChunkCoordinate coordinate = missing[idx].second;
+        m_pending_loads.emplace(coordinate, now);
+        m_thread_pool.submit([load_queue = m_load_queue, coordinate, settings = m_settings] {
+            LoadResult result = load_chunk(load_queue->loader, coordinate, settings);
+            std::lock_guard lock(load_queue->mutex);
+            load_queue->finished.push_back(std::move(result));
+        });
+    }
+}
+
+bool ChunkStreamer::update(const glm::vec3 &camera_position) {
+    bool changed = collect_finished_loads();
+    if (evict_chunks(camera_position)) {
+        changed = true;
+    }
+    if (!is_over_budget()) {
+        request_chunks(camera_position);
+    }
+    m_metrics.resident_chunks = m_chunks.size();
+    m_metrics.pending_loads = m_pending_loads.size();
+    return changed;
+}
+
+const std::unordered_map<ChunkCoordinate, ChunkStreamer::Chunk, ChunkCoordinateHash> &
+ChunkStreamer::chunks() const noexcept {
+    return m_chunks;
+}
+
+const ChunkStreamerMetrics &ChunkStreamer::metrics() const noexcept {
+    return m_metrics;
+}
+
+const ChunkStreamer::Settings &ChunkStreamer::settings() const noexcept {
+    return m_settings;
+}
+} // namespace inexor::vulkan_renderer::world
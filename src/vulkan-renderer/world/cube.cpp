@@ -1,47 +1,112 @@
 #include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/cube_batch.hpp"
 #include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
 
+#include <glm/geometric.hpp>
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <utility>
 
-void swap(inexor::vulkan_renderer::world::Cube &lhs, inexor::vulkan_renderer::world::Cube &rhs) noexcept {
+void swap(inexor::vulkan_renderer::world::Cube &lhs, inexor::vulkan_renderer::world::Cube &rhs) {
     std::swap(lhs.m_type, rhs.m_type);
     std::swap(lhs.m_size, rhs.m_size);
     std::swap(lhs.m_position, rhs.m_position);
-    std::swap(lhs.m_parent, rhs.m_parent);
     std::swap(lhs.m_indentations, rhs.m_indentations);
     std::swap(lhs.m_childs, rhs.m_childs);
     std::swap(lhs.m_polygon_cache, rhs.m_polygon_cache);
+    std::swap(lhs.m_polygon_count, rhs.m_polygon_count);
     std::swap(lhs.m_polygon_cache_valid, rhs.m_polygon_cache_valid);
+    std::swap(lhs.m_dirty, rhs.m_dirty);
+    std::swap(lhs.m_mesh_slot, rhs.m_mesh_slot);
+    std::swap(lhs.m_released_mesh_slots, rhs.m_released_mesh_slots);
+    std::swap(lhs.m_snapshot, rhs.m_snapshot);
+    lhs.link_childs();
+    rhs.link_childs();
 }
 
 namespace inexor::vulkan_renderer::world {
-void Cube::remove_childs() {
-    for (auto &child : m_childs) {
-        child->remove_childs();
-        child.reset();
+namespace {
+/// Number of Type::NORMAL cubes whose polygons are generated at once, so the polygons of a batch stay in the cache.
+constexpr std::size_t NORMAL_CUBE_BATCH_SIZE = 256;
+
+/// Part of a ray inside an axis aligned box.
+struct BoxIntersection {
+    float near;
+    float far;
+    /// Axis of the face through which the ray enters the box.
+    std::size_t axis;
+};
+
+/// Slab test of a ray against an axis aligned box.
+std::optional<BoxIntersection> intersect_box(const glm::vec3 &origin, const glm::vec3 &inverse_direction,
+                                             const glm::vec3 &position, const float size) {
+    BoxIntersection result{-std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity(), 0};
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        // A ray parallel to the slab never crosses its planes, and 0 * inf would give NaN on them.
+        if (std::isinf(inverse_direction[axis])) {
+            if (origin[axis] < position[axis] || origin[axis] > position[axis] + size) {
+                return std::nullopt;
+            }
+            continue;
+        }
+        float near = (position[axis] - origin[axis]) * inverse_direction[axis];
+        float far = (position[axis] + size - origin[axis]) * inverse_direction[axis];
+        if (near > far) {
+            std::swap(near, far);
+        }
+        if (near > result.near) {
+            result.near = near;
+            result.axis = axis;
+        }
+        result.far = std::min(result.far, far);
     }
+    if (result.near > result.far || result.far < 0) {
+        return std::nullopt;
+    }
+    return result;
 }
 
-std::weak_ptr<Cube> Cube::root() const noexcept {
-    if (auto parent = m_parent.lock(); parent != nullptr) {
-        while (!parent->is_root()) {
-            parent = parent->m_parent.lock();
-        }
-        return parent;
+/// Möller-Trumbore intersection of a ray and a triangle.
+/// @return Distance of the hit in multiples of the direction.
+std::optional<float> intersect_polygon(const glm::vec3 &origin, const glm::vec3 &direction, const Polygon &polygon) {
+    const glm::vec3 edge1 = polygon[1] - polygon[0];
+    const glm::vec3 edge2 = polygon[2] - polygon[0];
+    const glm::vec3 p = glm::cross(direction, edge2);
+    const float determinant = glm::dot(edge1, p);
+    // Parallel to the ray or a degenerated polygon.
+    if (std::abs(determinant) < std::numeric_limits<float>::epsilon()) {
+        return std::nullopt;
+    }
+    const float inverse_determinant = 1.0F / determinant;
+    const glm::vec3 t = origin - polygon[0];
+    const float u = glm::dot(t, p) * inverse_determinant;
+    if (u < 0.0F || u > 1.0F) {
+        return std::nullopt;
     }
-    return m_parent;
+    const glm::vec3 q = glm::cross(t, edge1);
+    const float v = glm::dot(direction, q) * inverse_determinant;
+    if (v < 0.0F || u + v > 1.0F) {
+        return std::nullopt;
+    }
+    return glm::dot(edge2, q) * inverse_determinant;
 }
 
-std::array<glm::vec3, 8> Cube::vertices() const noexcept {
-    assert(m_type == Type::SOLID || m_type == Type::NORMAL);
+} // namespace
 
-    const glm::vec3 pos = m_position;
-    const glm::vec3 max = {m_position.x + m_size, m_position.y + m_size, m_position.z + m_size};
+std::array<glm::vec3, 8> Cube::make_vertices(const Type type, const float size, const glm::vec3 &position,
+                                             const std::array<Indentation, Cube::EDGES> &indentations) noexcept {
+    assert(type == Type::SOLID || type == Type::NORMAL);
 
-    if (m_type == Type::SOLID) {
+    const glm::vec3 pos = position;
+    const glm::vec3 max = {position.x + size, position.y + size, position.z + size};
+
+    if (type == Type::SOLID) {
         return {{{pos.x, pos.y, pos.z},
                  {pos.x, pos.y, max.z},
                  {pos.x, max.y, pos.z},
@@ -51,9 +116,9 @@ std::array<glm::vec3, 8> Cube::vertices() const noexcept {
                  {max.x, max.y, pos.z},
                  {max.x, max.y, max.z}}};
     }
-    if (m_type == Type::NORMAL) {
-        const float step = m_size / Indentation::MAX;
-        const std::array<Indentation, Cube::EDGES> &ind = m_indentations;
+    if (type == Type::NORMAL) {
+        const float step = size / Indentation::MAX;
+        const std::array<Indentation, Cube::EDGES> &ind = indentations;
 
         return {{{pos.x + ind[0].start() * step, pos.y + ind[1].start() * step, pos.z + ind[2].start() * step},
                  {pos.x + ind[9].start() * step, pos.y + ind[4].start() * step, max.z - ind[2].end() * step},
@@ -67,6 +132,294 @@ std::array<glm::vec3, 8> Cube::vertices() const noexcept {
     return {};
 }
 
+std::array<Polygon, Cube::POLYGONS>
+Cube::make_polygons(const Type type, const float size, const glm::vec3 &position,
+                    const std::array<Indentation, Cube::EDGES> &indentations) noexcept {
+    assert(type == Type::SOLID || type == Type::NORMAL);
+
+    const std::array<glm::vec3, 8> v = make_vertices(type, size, position, indentations);
+    std::array<Polygon, Cube::POLYGONS> polygons{{
+        {{v[0], v[2], v[1]}}, // x = 0
+        {{v[1], v[2], v[3]}}, // x = 0
+        {{v[4], v[5], v[6]}}, // x = 1
+        {{v[5], v[7], v[6]}}, // x = 1
+        {{v[0], v[1], v[4]}}, // y = 0
+        {{v[1], v[5], v[4]}}, // y = 0
+        {{v[2], v[6], v[3]}}, // y = 1
+        {{v[3], v[6], v[7]}}, // y = 1
+        {{v[0], v[4], v[2]}}, // z = 0
+        {{v[2], v[4], v[6]}}, // z = 0
+        {{v[1], v[3], v[5]}}, // z = 1
+        {{v[3], v[7], v[5]}}  // z = 1
+    }};
+    if (type == Type::SOLID) {
+        return polygons;
+    }
+    const std::array<Indentation, Cube::EDGES> &ind = indentations;
+
+    // Check for each side if the side is convex, rotate the hypotenuse (middle diagonal edge) so it becomes convex!
+    // x = 0
+    if (ind[0].start() + ind[6].start() < ind[9].start() + ind[3].start()) {
+        polygons[0] = {{v[0], v[2], v[3]}};
+        polygons[1] = {{v[0], v[3], v[1]}};
+    }
+    // x = 1
+    if (ind[0].end() + ind[6].end() < ind[9].end() + ind[3].end()) {
+        polygons[2] = {{v[4], v[7], v[6]}};
+        polygons[3] = {{v[4], v[5], v[7]}};
+    }
+    // y = 0
+    if (ind[1].start() + ind[7].start() < ind[4].start() + ind[10].start()) {
+        polygons[4] = {{v[0], v[1], v[5]}};
+        polygons[5] = {{v[0], v[5], v[4]}};
+    }
+    // y = 1
+    if (ind[1].end() + ind[7].end() < ind[4].end() + ind[10].end()) {
+        polygons[6] = {{v[2], v[7], v[3]}};
+        polygons[7] = {{v[2], v[6], v[7]}};
+    }
+    // z = 0
+    if (ind[2].start() + ind[8].start() < ind[11].start() + ind[5].start()) {
+        polygons[8] = {{v[0], v[4], v[6]}};
+        polygons[9] = {{v[0], v[6], v[2]}};
+    }
+    // z = 1
+    if (ind[2].end() + ind[8].end() < ind[11].end() + ind[5].end()) {
+        polygons[10] = {{v[1], v[3], v[7]}};
+        polygons[11] = {{v[1], v[7], v[5]}};
+    }
+    return polygons;
+}
+
+void Cube::remove_childs() {
+    for (auto &child : m_childs) {
+        child->release_mesh_slots(m_released_mesh_slots);
+        child.reset();
+    }
+}
+
+void Cube::link_childs() {
+    visit_pre_order(*this, [](Cube &cube) {
+        if (cube.m_type != Type::OCTANT) {
+            return;
+        }
+        const std::weak_ptr<Cube> root = cube.root_reference();
+        for (const auto &child : cube.m_childs) {
+            child->m_parent = cube.weak_from_this();
+            child->m_root = root;
+            child->m_grid_level = cube.m_grid_level + 1;
+        }
+    });
+}
+
+void Cube::release_mesh_slots(std::vector<std::uint32_t> &released_mesh_slots) {
+    visit_pre_order(*this, [&](const Cube &cube) {
+        if (cube.m_mesh_slot != NO_MESH_SLOT) {
+            released_mesh_slots.push_back(cube.m_mesh_slot);
+            cube.m_mesh_slot = NO_MESH_SLOT;
+        }
+        released_mesh_slots.insert(released_mesh_slots.end(), cube.m_released_mesh_slots.begin(),
+                                   cube.m_released_mesh_slots.end());
+        cube.m_released_mesh_slots.clear();
+    });
+}
+
+void Cube::mark_dirty() const {
+    m_polygon_cache_valid = false;
+    m_dirty = true;
+    // If an ancestor is dirty already, all of its ancestors are dirty too.
+    for (auto parent = m_parent.lock(); parent != nullptr && parent.get() != this && !parent->m_dirty;
+         parent = parent->m_parent.lock()) {
+        parent->m_dirty = true;
+    }
+}
+
+void Cube::mark_subtree_dirty() {
+    visit_post_order(*this, [](const Cube &cube) {
+        cube.invalidate_snapshot();
+        cube.mark_dirty();
+    });
+}
+
+void Cube::invalidate_snapshot() const {
+    m_snapshot.reset();
+    for (auto parent = m_parent.lock(); parent != nullptr && parent.get() != this && parent->m_snapshot != nullptr;
+         parent = parent->m_parent.lock()) {
+        parent->m_snapshot.reset();
+    }
+}
+
+bool Cube::collapse() {
+    if (m_type != Type::OCTANT) {
+        return false;
+    }
+    const Type type = m_childs[0]->m_type;
+    if (type != Type::EMPTY && type != Type::SOLID) {
+        return false;
+    }
+    for (const auto &child : m_childs) {
+        if (child->m_type != type) {
+            return false;
+        }
+    }
+    // The leaf covers exactly the same space as its childs, so the neighbours don't need to be updated.
+    remove_childs();
+    m_type = type;
+    invalidate_snapshot();
+    mark_dirty();
+    return true;
+}
+
+void Cube::collapse_ancestors() {
+    // Keep this cube alive, as it is removed from the octree once its parent collapses.
+    const auto self = weak_from_this().lock();
+    for (auto parent = m_parent.lock(); parent != nullptr && parent.get() != this && parent->collapse();
+         parent = parent->m_parent.lock()) {
+    }
+}
+
+bool Cube::is_attached() const noexcept {
+    const Cube *cube = this;
+    while (cube->m_grid_level > 0) {
+        const auto parent = cube->m_parent.lock();
+        if (parent == nullptr || parent->m_type != Type::OCTANT ||
+            std::none_of(parent->m_childs.begin(), parent->m_childs.end(),
+                         [cube](const std::shared_ptr<Cube> &child) { return child.get() == cube; })) {
+            return false;
+        }
+        cube = parent.get();
+    }
+    return true;
+}
+
+std::weak_ptr<Cube> Cube::root() const noexcept {
+    return m_grid_level == 0 ? m_parent : m_root;
+}
+
+std::weak_ptr<Cube> Cube::root_reference() noexcept {
+    return m_grid_level == 0 ? weak_from_this() : m_root;
+}
+
+const Cube &Cube::root_cube() const noexcept {
+    if (m_grid_level == 0) {
+        return *this;
+    }
+    if (const auto root = m_root.lock(); root != nullptr) {
+        return *root;
+    }
+    // The octree has been copied into a cube which is not owned by a shared pointer, follow the parents instead.
+    const Cube *cube = this;
+    for (auto parent = cube->m_parent.lock(); parent != nullptr && parent.get() != cube;
+         parent = cube->m_parent.lock()) {
+        cube = parent.get();
+    }
+    return *cube;
+}
+
+const Cube *Cube::neighbour(const std::size_t axis, const bool positive_direction) const {
+    assert(axis < 3);
+    const Cube &root = root_cube();
+    glm::vec3 center = m_position + glm::vec3(m_size / 2);
+    center[axis] += positive_direction ? m_size : -m_size;
+
+    const glm::vec3 root_max = root.m_position + glm::vec3(root.m_size);
+    for (std::size_t idx = 0; idx < 3; idx++) {
+        if (center[idx] <= root.m_position[idx] || center[idx] >= root_max[idx]) {
+            return nullptr;
+        }
+    }
+
+    // Descend until a leaf or a cube of the same size is reached.
+    const Cube *cube = &root;
+    while (cube->m_type == Type::OCTANT && cube->m_size > m_size * 1.5F) {
+        const glm::vec3 middle = cube->m_position + glm::vec3(cube->m_size / 2);
+        // about the order look into the octree documentation
+        const std::size_t idx = (center.x >= middle.x ? 4U : 0U) | (center.y >= middle.y ? 2U : 0U) |
+                                (center.z >= middle.z ? 1U : 0U);
+        cube = cube->m_childs[idx].get();
+    }
+    return cube;
+}
+
+bool Cube::touches_face(const Cube &cube, const std::size_t axis, const bool positive_direction) const noexcept {
+    // Descendants are either flush with the face or at least their own size away, so rounding errors don't matter.
+    const float face = positive_direction ? m_position[axis] + m_size : m_position[axis];
+    const float cube_face = positive_direction ? cube.m_position[axis] + cube.m_size : cube.m_position[axis];
+    return std::abs(cube_face - face) < cube.m_size / 2;
+}
+
+bool Cube::covers_face(const std::size_t axis, const bool positive_direction) const {
+    // Corners and childs share the same order, the bit of the axis tells on which side they are.
+    const std::size_t axis_bit = 1U << (2 - axis);
+    bool covered = true;
+    // Only the descendants which touch the face are visited.
+    visit_pre_order(*this, [&](const Cube &cube) {
+        if (!covered || !touches_face(cube, axis, positive_direction)) {
+            return false;
+        }
+        switch (cube.m_type) {
+        case Type::OCTANT:
+            return true;
+        case Type::SOLID:
+            return false;
+        case Type::NORMAL: {
+            const auto indented = make_vertices(Type::NORMAL, cube.m_size, cube.m_position, cube.m_indentations);
+            const auto solid = make_vertices(Type::SOLID, cube.m_size, cube.m_position, {});
+            for (std::size_t corner = 0; corner < 8; corner++) {
+                if (((corner & axis_bit) != 0) == positive_direction && indented[corner] != solid[corner]) {
+                    covered = false;
+                }
+            }
+            return false;
+        }
+        default:
+            covered = false;
+            return false;
+        }
+    });
+    return covered;
+}
+
+bool Cube::is_face_hidden(const std::size_t axis, const bool positive_direction) const {
+    // An indented face is not on the cell border, so it can be seen from the inside of the cell.
+    if (!covers_face(axis, positive_direction)) {
+        return false;
+    }
+    const Cube *cube = neighbour(axis, positive_direction);
+    return cube != nullptr && cube->covers_face(axis, !positive_direction);
+}
+
+void Cube::mark_face_dirty(const std::size_t axis, const bool positive_direction) const {
+    visit_pre_order(*this, [&](const Cube &cube) {
+        if (!touches_face(cube, axis, positive_direction)) {
+            return false;
+        }
+        if (cube.m_type == Type::SOLID || cube.m_type == Type::NORMAL) {
+            cube.mark_dirty();
+        }
+        return true;
+    });
+}
+
+void Cube::mark_neighbours_dirty() const {
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        for (const bool positive_direction : {false, true}) {
+            if (const Cube *cube = neighbour(axis, positive_direction); cube != nullptr) {
+                cube->mark_face_dirty(axis, !positive_direction);
+            }
+        }
+    }
+}
+
+std::array<glm::vec3, 8> Cube::vertices() const noexcept {
+    return make_vertices(m_type, m_size, m_position, m_indentations);
+}
+
+std::shared_ptr<Cube> Cube::shared() const {
+    // Queries hand out the cubes for editing, like childs does.
+    return std::const_pointer_cast<Cube>(weak_from_this().lock());
+}
+
 /// 90 degree rotation.
 template <>
 void Cube::rotate<1>(const RotationAxis::Type &axis) {
@@ -94,9 +447,6 @@ void Cube::rotate<1>(const RotationAxis::Type &axis) {
             std::swap(m_childs[order[1]], m_childs[order[2]]);
             std::swap(m_childs[order[2]], m_childs[order[3]]);
         }
-        for (auto &child : m_childs) {
-            child->rotate<1>(axis);
-        }
     }
 }
 
@@ -125,9 +475,6 @@ void Cube::rotate<2>(const RotationAxis::Type &axis) {
             std::swap(m_childs[order[0]], m_childs[order[2]]);
             std::swap(m_childs[order[1]], m_childs[order[3]]);
         }
-        for (auto &child : m_childs) {
-            child->rotate<2>(axis);
-        }
     }
 }
 
@@ -156,9 +503,6 @@ void Cube::rotate<3>(const RotationAxis::Type &axis) {
             std::swap(m_childs[order[3]], m_childs[order[2]]);
             std::swap(m_childs[order[2]], m_childs[order[1]]);
         }
-        for (auto &child : m_childs) {
-            child->rotate<3>(axis);
-        }
     }
 }
 
@@ -171,34 +515,49 @@ Cube::Cube(const Type type, const float size, const glm::vec3 &position) : m_siz
 }
 
 Cube::Cube(std::weak_ptr<Cube> parent, const Type type, const float size, const glm::vec3 &position)
-    : Cube(type, size, position) {
-    m_parent = std::move(parent);
+    : m_size(size), m_position(position), m_parent(std::move(parent)) {
+    if (const auto parent_cube = m_parent.lock(); parent_cube != nullptr) {
+        m_root = parent_cube->root_reference();
+        m_grid_level = parent_cube->m_grid_level + 1;
+    }
     set_type(type);
 }
 
-Cube::Cube(const Cube &rhs) : Cube(rhs.m_type, rhs.m_size, rhs.m_position) {
-    if (!rhs.is_root()) {
-        m_parent = rhs.m_parent;
-    }
-    if (m_type == Type::NORMAL) {
-        m_indentations = rhs.m_indentations;
-    } else if (m_type == Type::OCTANT) {
-        for (std::size_t idx = 0; idx <= rhs.m_childs.size(); idx++) {
+Cube::Cube(const Cube &rhs)
+    : std::enable_shared_from_this<Cube>(), m_type(rhs.m_type), m_size(rhs.m_size), m_position(rhs.m_position),
+      m_indentations(rhs.m_indentations), m_polygon_count(rhs.m_polygon_count),
+      m_polygon_cache_valid(rhs.m_polygon_cache_valid), m_auto_compact(rhs.m_auto_compact),
+      m_snapshot(rhs.m_snapshot) {
+    // The copy has no parent and no root, so it is a root until it is linked. The grid level is set by link_childs.
+    std::copy_n(rhs.m_polygon_cache.begin(), rhs.m_polygon_count, m_polygon_cache.begin());
+    if (m_type == Type::OCTANT) {
+        for (std::size_t idx = 0; idx < rhs.m_childs.size(); idx++) {
             m_childs[idx] = std::make_shared<Cube>(*rhs.m_childs[idx]);
         }
     }
-    m_polygon_cache_valid = rhs.m_polygon_cache_valid;
-    if (m_type == Type::NORMAL || m_type == Type::SOLID) {
-        m_polygon_cache = std::make_shared<std::vector<Polygon>>(*rhs.m_polygon_cache);
-    }
 }
 
-Cube::Cube(Cube &&rhs) noexcept : Cube() {
+Cube::Cube(Cube &&rhs) : Cube() {
     swap(*this, rhs);
 }
 
+std::shared_ptr<Cube> Cube::clone() const {
+    auto cube = std::make_shared<Cube>(*this);
+    // The copy is owned by a shared pointer now, so its descendants can be linked to it.
+    cube->link_childs();
+    if (!is_root()) {
+        // The faces at the border of the subtree were culled by cubes which are not part of the copy.
+        visit_pre_order(*cube, [](const Cube &cube) { cube.invalidate_polygon_cache(); });
+    }
+    return cube;
+}
+
 Cube &Cube::operator=(Cube rhs) {
     swap(*this, rhs);
+    // rhs holds the previous state now, which will be destroyed.
+    rhs.release_mesh_slots(m_released_mesh_slots);
+    mark_subtree_dirty();
+    mark_neighbours_dirty();
     return *this;
 }
 
@@ -213,34 +572,141 @@ const std::shared_ptr<const Cube> Cube::operator[](std::size_t idx) const {
 }
 
 bool Cube::is_root() const noexcept {
-    return &(*m_parent.lock()) == this;
+    return m_grid_level == 0;
 }
 
 std::size_t Cube::grid_level() const noexcept {
-    std::size_t level = 0;
-    std::shared_ptr<Cube> parent = m_parent.lock();
-    while (!parent->is_root()) {
-        parent = parent->m_parent.lock();
-        level++;
-    }
-    return level;
+    return m_grid_level;
 }
 
-std::size_t Cube::count_geometry_cubes() const noexcept {
-    if (m_type == Type::SOLID || m_type == Type::NORMAL) {
-        return 1;
-    }
-    if (m_type == Type::OCTANT) {
-        std::size_t count = 0;
-        for (const auto &cube : m_childs) {
-            count += cube->count_geometry_cubes();
+bool Cube::is_dirty() const noexcept {
+    return m_dirty;
+}
+
+std::size_t Cube::compact() {
+    std::size_t removed_cubes = 0;
+    // The childs of an octant are already compacted when it is visited, so uniformity propagates upwards.
+    visit_post_order(*this, [&removed_cubes](Cube &cube) {
+        if (cube.collapse()) {
+            removed_cubes += SUB_CUBES;
         }
-        return count;
-    }
-    return 0;
+    });
+    return removed_cubes;
+}
+
+void Cube::set_auto_compact(const bool enabled) noexcept {
+    m_auto_compact = enabled;
+}
+
+bool Cube::auto_compact() const noexcept {
+    return m_auto_compact;
+}
+
+OctreeSnapshot Cube::snapshot() const {
+    // Leaves without indentations don't differ, so all snapshots share them.
+    static const auto empty_node = std::make_shared<const SnapshotNode>(SnapshotNode{Type::EMPTY});
+    static const auto solid_node = std::make_shared<const SnapshotNode>(SnapshotNode{Type::SOLID});
+
+    // Subtrees with a snapshot node have not been changed, their nodes are reused.
+    traverse_octree(
+        *this, [](const Cube &cube) { return cube.m_snapshot == nullptr; },
+        [](const Cube &cube) {
+            if (cube.m_snapshot != nullptr) {
+                return;
+            }
+            switch (cube.m_type) {
+            case Type::EMPTY:
+                cube.m_snapshot = empty_node;
+                break;
+            case Type::SOLID:
+                cube.m_snapshot = solid_node;
+                break;
+            case Type::NORMAL:
+                cube.m_snapshot = std::make_shared<const SnapshotNode>(SnapshotNode{Type::NORMAL, cube.m_indentations});
+                break;
+            case Type::OCTANT: {
+                SnapshotNode node{Type::OCTANT};
+                for (std::size_t idx = 0; idx < SUB_CUBES; idx++) {
+                    node.childs[idx] = cube.m_childs[idx]->m_snapshot;
+                }
+                cube.m_snapshot = std::make_shared<const SnapshotNode>(std::move(node));
+                break;
+            }
+            }
+        });
+    return {m_size, m_position, m_snapshot};
+}
+
+void Cube::restore(const OctreeSnapshot &snapshot) {
+    assert(snapshot.size() == m_size && snapshot.position() == m_position);
+    // Nodes of the snapshot which are restored into the next cubes in pre-order.
+    std::vector<const std::shared_ptr<const SnapshotNode> *> nodes{&snapshot.root()};
+    // Ancestors are not collapsed, so the structure matches the snapshot.
+    visit_pre_order(*this, [&nodes](Cube &cube) {
+        const std::shared_ptr<const SnapshotNode> &node = *nodes.back();
+        nodes.pop_back();
+        if (cube.m_snapshot == node) {
+            return false;
+        }
+        cube.change_type(node->type);
+        if (node->type == Type::NORMAL && cube.m_indentations != node->indentations) {
+            cube.m_indentations = node->indentations;
+            cube.invalidate_snapshot();
+            cube.mark_dirty();
+            cube.mark_neighbours_dirty();
+        } else if (node->type == Type::OCTANT) {
+            // Reverse order, so the first child is taken next.
+            for (std::size_t idx = SUB_CUBES; idx-- > 0;) {
+                nodes.push_back(&node->childs[idx]);
+            }
+        }
+        return true;
+    });
+    // The cubes are identical to the snapshot now, so its nodes can be shared.
+    nodes = {&snapshot.root()};
+    visit_pre_order(*this, [&nodes](const Cube &cube) {
+        const std::shared_ptr<const SnapshotNode> &node = *nodes.back();
+        nodes.pop_back();
+        if (cube.m_snapshot == node) {
+            return false;
+        }
+        cube.m_snapshot = node;
+        for (std::size_t idx = SUB_CUBES; cube.m_type == Type::OCTANT && idx-- > 0;) {
+            nodes.push_back(&node->childs[idx]);
+        }
+        return true;
+    });
+}
+
+std::size_t Cube::count_geometry_cubes() const {
+    std::size_t count = 0;
+    visit_leaves(*this, [&count](const Cube &cube) {
+        if (cube.m_type == Type::SOLID || cube.m_type == Type::NORMAL) {
+            count++;
+        }
+    });
+    return count;
 }
 
 void Cube::set_type(const Type new_type) {
+    change_type(new_type);
+    // A new octant has eight Type::SOLID childs, which must not be collapsed right away.
+    if ((new_type == Type::EMPTY || new_type == Type::SOLID) && root_cube().m_auto_compact) {
+        collapse_ancestors();
+    }
+}
+
+void Cube::change_type(const Type new_type) {
+    if (m_type == new_type) {
+        return;
+    }
+    apply_type(new_type);
+    invalidate_snapshot();
+    mark_dirty();
+    mark_neighbours_dirty();
+}
+
+void Cube::apply_type(const Type new_type) {
     if (m_type == new_type) {
         return;
     }
@@ -253,8 +719,13 @@ void Cube::set_type(const Type new_type) {
         break;
     case Type::OCTANT:
         const float half_size = m_size / 2;
+        const std::weak_ptr<Cube> root = root_reference();
         auto create_cube = [&](const glm::vec3 &offset) {
-            return std::make_shared<Cube>(weak_from_this(), Type::SOLID, half_size, m_position + offset);
+            auto cube = std::make_shared<Cube>(Type::SOLID, half_size, m_position + offset);
+            cube->m_parent = weak_from_this();
+            cube->m_root = root;
+            cube->m_grid_level = m_grid_level + 1;
+            return cube;
         };
         // about the order look into the octree documentation
         m_childs = {create_cube({0, 0, 0}),
@@ -270,15 +741,21 @@ void Cube::set_type(const Type new_type) {
     if (m_type == Type::OCTANT && new_type != Type::OCTANT) {
         remove_childs();
     }
-    m_polygon_cache_valid = false;
     m_type = new_type;
-    // TODO: clean up if whole octant is empty, etc.
 }
 
 Cube::Type Cube::type() const noexcept {
     return m_type;
 }
 
+float Cube::size() const noexcept {
+    return m_size;
+}
+
+glm::vec3 Cube::position() const noexcept {
+    return m_position;
+}
+
 const std::array<std::shared_ptr<Cube>, Cube::SUB_CUBES> &Cube::childs() const {
     return m_childs;
 }
@@ -293,6 +770,9 @@ void Cube::set_indent(const std::uint8_t edge_id, Indentation indentation) {
     }
     assert(edge_id <= Cube::EDGES);
     m_indentations[edge_id] = indentation;
+    invalidate_snapshot();
+    mark_dirty();
+    mark_neighbours_dirty();
 }
 
 void Cube::indent(const std::uint8_t edge_id, const bool positive_direction, const std::uint8_t steps) {
@@ -305,7 +785,9 @@ void Cube::indent(const std::uint8_t edge_id, const bool positive_direction, con
     } else {
         m_indentations[edge_id].indent_end(steps);
     }
-    m_polygon_cache_valid = false;
+    invalidate_snapshot();
+    mark_dirty();
+    mark_neighbours_dirty();
 }
 
 void Cube::rotate(const RotationAxis::Type &axis, int rotations) {
@@ -313,108 +795,239 @@ void Cube::rotate(const RotationAxis::Type &axis, int rotations) {
     if (rotations == 0 || m_type == Type::EMPTY || m_type == Type::SOLID) {
         return;
     }
-    switch (rotations) {
-    case 1:
-        rotate<1>(axis);
-        break;
-    case 2:
-        rotate<2>(axis);
-        break;
-    case 3:
-        rotate<3>(axis);
-        break;
-    }
+    // The children are reordered before they are visited, so every cube is rotated once.
+    visit_pre_order(*this, [&](Cube &cube) {
+        switch (rotations) {
+        case 1:
+            cube.rotate<1>(axis);
+            break;
+        case 2:
+            cube.rotate<2>(axis);
+            break;
+        case 3:
+            cube.rotate<3>(axis);
+            break;
+        }
+    });
+    mark_subtree_dirty();
+    mark_neighbours_dirty();
 }
 
 void Cube::update_polygon_cache() const {
+    m_polygon_count = 0;
+    m_polygon_cache_valid = true;
     if (m_type == Type::OCTANT || m_type == Type::EMPTY) {
-        m_polygon_cache = nullptr;
-        m_polygon_cache_valid = true;
-        return;
-    }
-    const std::array<glm::vec3, 8> v = vertices();
-    m_polygon_cache = std::make_shared<std::vector<Polygon>>(std::vector<Polygon>{
-        {{v[0], v[2], v[1]}}, // x = 0
-        {{v[1], v[2], v[3]}}, // x = 0
-        {{v[4], v[5], v[6]}}, // x = 1
-        {{v[5], v[7], v[6]}}, // x = 1
-        {{v[0], v[1], v[4]}}, // y = 0
-        {{v[1], v[5], v[4]}}, // y = 0
-        {{v[2], v[6], v[3]}}, // y = 1
-        {{v[3], v[6], v[7]}}, // y = 1
-        {{v[0], v[4], v[2]}}, // z = 0
-        {{v[2], v[4], v[6]}}, // z = 0
-        {{v[1], v[3], v[5]}}, // z = 1
-        {{v[3], v[7], v[5]}}  // z = 1
-    });
-    if (m_type == Type::SOLID) {
-        m_polygon_cache_valid = true;
         return;
     }
-    if (m_type == Type::NORMAL) {
-        const std::array<Indentation, Cube::EDGES> ind = m_indentations;
-
-        // Check for each side if the side is convex, rotate the hypotenuse (middle diagonal edge) so it becomes convex!
-        // x = 0
-        if (ind[0].start() + ind[6].start() < ind[9].start() + ind[3].start()) {
-            (*m_polygon_cache)[0] = {{v[0], v[2], v[3]}};
-            (*m_polygon_cache)[1] = {{v[0], v[3], v[1]}};
-        }
-        // x = 1
-        if (ind[0].end() + ind[6].end() < ind[9].end() + ind[3].end()) {
-            (*m_polygon_cache)[2] = {{v[4], v[7], v[6]}};
-            (*m_polygon_cache)[3] = {{v[4], v[5], v[7]}};
-        }
-        // y = 0
-        if (ind[1].start() + ind[7].start() < ind[4].start() + ind[10].start()) {
-            (*m_polygon_cache)[4] = {{v[0], v[1], v[5]}};
-            (*m_polygon_cache)[5] = {{v[0], v[5], v[4]}};
-        }
-        // y = 1
-        if (ind[1].end() + ind[7].end() < ind[4].end() + ind[10].end()) {
-            (*m_polygon_cache)[6] = {{v[2], v[7], v[3]}};
-            (*m_polygon_cache)[7] = {{v[2], v[6], v[7]}};
-        }
-        // z = 0
-        if (ind[2].start() + ind[8].start() < ind[11].start() + ind[5].start()) {
-            (*m_polygon_cache)[8] = {{v[0], v[4], v[6]}};
-            (*m_polygon_cache)[9] = {{v[0], v[6], v[2]}};
-        }
-        // z = 1
-        if (ind[2].end() + ind[8].end() < ind[11].end() + ind[5].end()) {
-            (*m_polygon_cache)[10] = {{v[1], v[3], v[7]}};
-            (*m_polygon_cache)[11] = {{v[1], v[7], v[5]}};
-        }
-        m_polygon_cache_valid = true;
-        return;
+    const std::array<Polygon, Cube::POLYGONS> polygons = make_polygons(m_type, m_size, m_position, m_indentations);
+    update_polygon_cache(polygons);
+}
+
+void Cube::update_polygon_cache(const tools::Span<const Polygon> polygons) const {
+    assert(polygons.size() == Cube::POLYGONS);
+    m_polygon_count = 0;
+    m_polygon_cache_valid = true;
+    // Every face consists of two polygons, ordered by axis and direction.
+    for (std::size_t face = 0; face < 6; face++) {
+        if (is_face_hidden(face / 2, face % 2 == 1)) {
+            continue;
+        }
+        m_polygon_cache[m_polygon_count++] = polygons[2 * face];
+        m_polygon_cache[m_polygon_count++] = polygons[2 * face + 1];
     }
-    // This point should not be reached.
-    assert(false);
 }
+
 void Cube::invalidate_polygon_cache() const {
     m_polygon_cache_valid = false;
 }
+
+PolygonCache Cube::polygon_cache() const noexcept {
+    if (m_type != Type::SOLID && m_type != Type::NORMAL) {
+        return {};
+    }
+    return {m_polygon_cache.data(), m_polygon_count};
+}
+
+std::size_t Cube::count_hidden_polygons() const {
+    std::size_t count = 0;
+    visit_leaves(*this, [&count](const Cube &cube) {
+        if (cube.m_polygon_cache_valid && (cube.m_type == Type::SOLID || cube.m_type == Type::NORMAL)) {
+            count += Cube::POLYGONS - cube.m_polygon_count;
+        }
+    });
+    return count;
+}
+
+void Cube::update_polygon_caches() const {
+    NormalCubeBatch batch;
+    batch.reserve(NORMAL_CUBE_BATCH_SIZE);
+    std::vector<const Cube *> batch_cubes;
+    batch_cubes.reserve(NORMAL_CUBE_BATCH_SIZE);
+    std::vector<Polygon> batch_polygons(NORMAL_CUBE_BATCH_SIZE * POLYGONS);
+    const auto update_batch = [&] {
+        make_normal_polygons(batch, batch_polygons);
+        for (std::size_t idx = 0; idx < batch_cubes.size(); idx++) {
+            const auto polygons = tools::Span<const Polygon>(batch_polygons).subspan(idx * POLYGONS, POLYGONS);
+            batch_cubes[idx]->update_polygon_cache(polygons);
+        }
+        batch.clear();
+        batch_cubes.clear();
+    };
+
+    visit_leaves(*this, [&](const Cube &cube) {
+        if (cube.m_polygon_cache_valid) {
+            return;
+        }
+        if (cube.m_type != Type::NORMAL) {
+            cube.update_polygon_cache();
+            return;
+        }
+        batch.push_back(cube.m_size, cube.m_position, cube.m_indentations);
+        batch_cubes.push_back(&cube);
+        if (batch_cubes.size() == NORMAL_CUBE_BATCH_SIZE) {
+            update_batch();
+        }
+    });
+    if (!batch_cubes.empty()) {
+        update_batch();
+    }
+}
+
 std::vector<PolygonCache> Cube::polygons(const bool update_invalid) const {
+    if (update_invalid) {
+        update_polygon_caches();
+    }
     std::vector<PolygonCache> polygons;
     polygons.reserve(count_geometry_cubes());
 
-    std::function<void(std::shared_ptr<const world::Cube>)> collect;
-    // post-order traversal
-    collect = [&collect, &polygons, &update_invalid](std::shared_ptr<const world::Cube> cube) {
-        if (cube->type() == world::Cube::Type::OCTANT) {
-            for (const auto &child : cube->childs()) {
-                collect(child);
-            }
+    visit_leaves(*this, [&polygons](const Cube &cube) {
+        if (cube.m_type == Type::EMPTY) {
             return;
         }
-        if (!cube->m_polygon_cache_valid && update_invalid) {
-            cube->update_polygon_cache();
+        polygons.push_back(cube.polygon_cache());
+    });
+    return polygons;
+}
+
+std::optional<RayHit> Cube::raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+                                    const float max_distance) const {
+    const glm::vec3 inverse_direction = 1.0F / direction;
+    // The ray passes the childs in ascending order of idx ^ mirror, as the bits of the child index are the axes. About
+    // the order look into the octree documentation.
+    const std::size_t mirror =
+        (direction.x < 0 ? 4U : 0U) | (direction.y < 0 ? 2U : 0U) | (direction.z < 0 ? 1U : 0U);
+    std::vector<const Cube *> stack{this};
+    while (!stack.empty()) {
+        const Cube *cube = stack.back();
+        stack.pop_back();
+        const auto box = intersect_box(origin, inverse_direction, cube->m_position, cube->m_size);
+        if (!box || box->near > max_distance) {
+            continue;
+        }
+        switch (cube->m_type) {
+        case Type::EMPTY:
+            break;
+        case Type::OCTANT:
+            // Reverse order, so the first child is taken next.
+            for (std::size_t idx = SUB_CUBES; idx-- > 0;) {
+                stack.push_back(cube->m_childs[idx ^ mirror].get());
+            }
+            break;
+        case Type::SOLID:
+            return RayHit{cube->shared(), std::max(box->near, 0.0F), box->axis, direction[box->axis] < 0};
+        case Type::NORMAL: {
+            const auto polygons = make_polygons(Type::NORMAL, cube->m_size, cube->m_position, cube->m_indentations);
+            std::optional<RayHit> hit;
+            for (std::size_t idx = 0; idx < POLYGONS; idx++) {
+                const auto distance = intersect_polygon(origin, direction, polygons[idx]);
+                if (distance && *distance >= 0 && *distance <= max_distance && (!hit || *distance < hit->distance)) {
+                    // Every face consists of two polygons, ordered by axis and direction.
+                    hit = RayHit{nullptr, *distance, idx / 4, (idx / 2) % 2 == 1};
+                }
+            }
+            if (hit) {
+                hit->cube = cube->shared();
+                return hit;
+            }
+            break;
         }
-        if (cube->m_polygon_cache != nullptr) {
-            polygons.push_back(cube->m_polygon_cache);
         }
-    };
-    collect(this->shared_from_this());
+    }
+    return std::nullopt;
+}
+
+std::shared_ptr<Cube> Cube::leaf_at(const glm::vec3 &point) const {
+    for (std::size_t axis = 0; axis < 3; axis++) {
+        if (point[axis] < m_position[axis] || point[axis] > m_position[axis] + m_size) {
+            return nullptr;
+        }
+    }
+    const Cube *cube = this;
+    while (cube->m_type == Type::OCTANT) {
+        const glm::vec3 middle = cube->m_position + glm::vec3(cube->m_size / 2);
+        // about the order look into the octree documentation
+        const std::size_t idx =
+            (point.x >= middle.x ? 4U : 0U) | (point.y >= middle.y ? 2U : 0U) | (point.z >= middle.z ? 1U : 0U);
+        cube = cube->m_childs[idx].get();
+    }
+    return cube->shared();
+}
+
+std::vector<std::shared_ptr<Cube>> Cube::leaves_in_box(const glm::vec3 &min, const glm::vec3 &max) const {
+    std::vector<std::shared_ptr<Cube>> leaves;
+    // Subtrees outside of the box are skipped.
+    visit_pre_order(*this, [&](const Cube &cube) {
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            if (cube.m_position[axis] >= max[axis] || cube.m_position[axis] + cube.m_size <= min[axis]) {
+                return false;
+            }
+        }
+        if (cube.m_type != Type::OCTANT) {
+            leaves.push_back(cube.shared());
+        }
+        return true;
+    });
+    return leaves;
+}
+
+std::vector<PolygonCache> Cube::polygons(tools::ThreadPool &thread_pool, const bool update_invalid) const {
+    // Several subtrees per worker balance octrees of uneven density. Replacing an octant by its children keeps the
+    // order of the leaves, so the results can simply be concatenated.
+    const std::size_t subtree_target = thread_pool.worker_count() * 8;
+    std::vector<const Cube *> subtrees{this};
+    while (subtrees.size() < subtree_target) {
+        std::vector<const Cube *> next_subtrees;
+        next_subtrees.reserve(subtrees.size() * SUB_CUBES);
+        for (const Cube *subtree : subtrees) {
+            if (subtree->m_type != Type::OCTANT) {
+                next_subtrees.push_back(subtree);
+                continue;
+            }
+            for (const auto &child : subtree->m_childs) {
+                next_subtrees.push_back(child.get());
+            }
+        }
+        if (next_subtrees.size() == subtrees.size()) {
+            break;
+        }
+        subtrees = std::move(next_subtrees);
+    }
+
+    // Updating a cache only reads the neighbours, so the subtrees can be processed independently.
+    std::vector<std::vector<PolygonCache>> subtree_polygons(subtrees.size());
+    thread_pool.parallel_for(subtrees.size(), [&](const std::size_t idx) {
+        subtree_polygons[idx] = subtrees[idx]->polygons(update_invalid);
+    });
+
+    std::size_t polygon_count = 0;
+    for (const auto &caches : subtree_polygons) {
+        polygon_count += caches.size();
+    }
+    std::vector<PolygonCache> polygons;
+    polygons.reserve(polygon_count);
+    for (auto &caches : subtree_polygons) {
+        polygons.insert(polygons.end(), caches.begin(), caches.end());
+    }
     return polygons;
 }
 } // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,216 @@
+#include "inexor/vulkan-renderer/world/cube_batch.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define INEXOR_NORMAL_POLYGONS_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define INEXOR_NORMAL_POLYGONS_SSE2
+#endif
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+/// Every edge gives two coordinates on its axis: the indented start and the indented end.
+constexpr std::size_t COORDINATES = Cube::EDGES * 2;
+
+/// Coordinates of the eight corners, in the same order as Cube::make_vertices: edge * 2 + (1 if end of edge).
+constexpr std::array<std::array<std::uint8_t, 3>, 8> CORNER_COORDINATES{{
+    {{0 * 2, 1 * 2, 2 * 2}},
+    {{9 * 2, 4 * 2, 2 * 2 + 1}},
+    {{3 * 2, 1 * 2 + 1, 11 * 2}},
+    {{6 * 2, 4 * 2 + 1, 11 * 2 + 1}},
+    {{0 * 2 + 1, 10 * 2, 5 * 2}},
+    {{9 * 2 + 1, 7 * 2, 5 * 2 + 1}},
+    {{3 * 2 + 1, 10 * 2 + 1, 8 * 2}},
+    {{6 * 2 + 1, 7 * 2 + 1, 8 * 2 + 1}},
+}};
+
+/// Corners of the two polygons of every face, in the same order as Cube::make_polygons.
+constexpr std::array<std::array<std::uint8_t, 6>, 6> FACE_CORNERS{{
+    {{0, 2, 1, 1, 2, 3}},
+    {{4, 5, 6, 5, 7, 6}},
+    {{0, 1, 4, 1, 5, 4}},
+    {{2, 6, 3, 3, 6, 7}},
+    {{0, 4, 2, 2, 4, 6}},
+    {{1, 3, 5, 3, 7, 5}},
+}};
+/// Corners of the two polygons of every face, if the hypotenuse has to be rotated to keep the face convex.
+constexpr std::array<std::array<std::uint8_t, 6>, 6> ROTATED_FACE_CORNERS{{
+    {{0, 2, 3, 0, 3, 1}},
+    {{4, 7, 6, 4, 5, 7}},
+    {{0, 1, 5, 0, 5, 4}},
+    {{2, 7, 3, 2, 6, 7}},
+    {{0, 4, 6, 0, 6, 2}},
+    {{1, 3, 7, 1, 7, 5}},
+}};
+/// The hypotenuse of a face is rotated if the indents of the first two edges are less than the ones of the last two.
+constexpr std::array<std::array<std::uint8_t, 4>, 3> FACE_EDGES{{{{0, 6, 9, 3}}, {{1, 7, 4, 10}}, {{2, 8, 11, 5}}}};
+
+/// Raw pointers into the structure of arrays.
+struct BatchData {
+    std::array<const float *, 3> positions;
+    const float *sizes;
+    std::array<const std::uint8_t *, Cube::EDGES> indentations;
+};
+
+/// Write the polygons of one cube from its edge coordinates.
+/// @param coordinates Edge coordinates of the cube, coordinate ``k`` is at ``coordinates[k * stride]``.
+void emit_polygons(const BatchData &data, const std::size_t cube, const float *coordinates, const std::size_t stride,
+                   Polygon *output) {
+    std::array<glm::vec3, 8> corners;
+    for (std::size_t corner = 0; corner < corners.size(); corner++) {
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            corners[corner][axis] = coordinates[CORNER_COORDINATES[corner][axis] * stride];
+        }
+    }
+    for (std::size_t face = 0; face < FACE_CORNERS.size(); face++) {
+        // Even faces compare the indents of the starts, odd faces the indents of the ends.
+        const unsigned shift = (face % 2) * 4;
+        const auto &edges = FACE_EDGES[face / 2];
+        const auto indent = [&](const std::size_t idx) {
+            return (data.indentations[edges[idx]][cube] >> shift) & 0x0FU;
+        };
+        const bool rotate = indent(0) + indent(1) < indent(2) + indent(3);
+        const auto &face_corners = rotate ? ROTATED_FACE_CORNERS[face] : FACE_CORNERS[face];
+        output[2 * face] = {{corners[face_corners[0]], corners[face_corners[1]], corners[face_corners[2]]}};
+        output[2 * face + 1] = {{corners[face_corners[3]], corners[face_corners[4]], corners[face_corners[5]]}};
+    }
+}
+
+void make_polygons_scalar(const BatchData &data, const std::size_t cube, Polygon *output) {
+    std::array<float, COORDINATES> coordinates;
+    const float step = data.sizes[cube] / Indentation::MAX;
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        const float position = data.positions[edge % 3][cube];
+        const float max = position + data.sizes[cube];
+        const std::uint8_t packed = data.indentations[edge][cube];
+        coordinates[2 * edge] = position + static_cast<float>(packed & 0x0FU) * step;
+        coordinates[2 * edge + 1] = max - static_cast<float>(packed >> 4U) * step;
+    }
+    emit_polygons(data, cube, coordinates.data(), 1, output);
+}
+
+#if defined(INEXOR_NORMAL_POLYGONS_AVX2)
+constexpr std::size_t LANES = 8;
+constexpr const char *INSTRUCTION_SET = "AVX2";
+
+void make_polygons_simd(const BatchData &data, const std::size_t first_cube, Polygon *output) {
+    alignas(32) std::array<float, COORDINATES * LANES> coordinates;
+    const __m256 sizes = _mm256_loadu_ps(data.sizes + first_cube);
+    const __m256 step = _mm256_div_ps(sizes, _mm256_set1_ps(Indentation::MAX));
+    const __m256i nibble = _mm256_set1_epi32(0x0F);
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        const __m256 position = _mm256_loadu_ps(data.positions[edge % 3] + first_cube);
+        const __m256 max = _mm256_add_ps(position, sizes);
+        const __m256i packed = _mm256_cvtepu8_epi32(
+            _mm_loadl_epi64(reinterpret_cast<const __m128i *>(data.indentations[edge] + first_cube)));
+        const __m256 start = _mm256_cvtepi32_ps(_mm256_and_si256(packed, nibble));
+        const __m256 end = _mm256_cvtepi32_ps(_mm256_srli_epi32(packed, 4));
+        _mm256_store_ps(&coordinates[2 * edge * LANES], _mm256_add_ps(position, _mm256_mul_ps(start, step)));
+        _mm256_store_ps(&coordinates[(2 * edge + 1) * LANES], _mm256_sub_ps(max, _mm256_mul_ps(end, step)));
+    }
+    for (std::size_t lane = 0; lane < LANES; lane++) {
+        emit_polygons(data, first_cube + lane, &coordinates[lane], LANES, output + lane * Cube::POLYGONS);
+    }
+}
+#elif defined(INEXOR_NORMAL_POLYGONS_SSE2)
+constexpr std::size_t LANES = 4;
+constexpr const char *INSTRUCTION_SET = "SSE2";
+
+void make_polygons_simd(const BatchData &data, const std::size_t first_cube, Polygon *output) {
+    alignas(16) std::array<float, COORDINATES * LANES> coordinates;
+    const __m128 sizes = _mm_loadu_ps(data.sizes + first_cube);
+    const __m128 step = _mm_div_ps(sizes, _mm_set1_ps(Indentation::MAX));
+    const __m128i nibble = _mm_set1_epi32(0x0F);
+    const __m128i zero = _mm_setzero_si128();
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        const __m128 position = _mm_loadu_ps(data.positions[edge % 3] + first_cube);
+        const __m128 max = _mm_add_ps(position, sizes);
+        std::int32_t bytes;
+        std::memcpy(&bytes, data.indentations[edge] + first_cube, sizeof(bytes));
+        // Zero extend the four bytes to four 32 bit integers.
+        const __m128i packed =
+            _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+        const __m128 start = _mm_cvtepi32_ps(_mm_and_si128(packed, nibble));
+        const __m128 end = _mm_cvtepi32_ps(_mm_srli_epi32(packed, 4));
+        _mm_store_ps(&coordinates[2 * edge * LANES], _mm_add_ps(position, _mm_mul_ps(start, step)));
+        _mm_store_ps(&coordinates[(2 * edge + 1) * LANES], _mm_sub_ps(max, _mm_mul_ps(end, step)));
+    }
+    for (std::size_t lane = 0; lane < LANES; lane++) {
+        emit_polygons(data, first_cube + lane, &coordinates[lane], LANES, output + lane * Cube::POLYGONS);
+    }
+}
+#else
+constexpr std::size_t LANES = 1;
+constexpr const char *INSTRUCTION_SET = "scalar";
+
+void make_polygons_simd(const BatchData &data, const std::size_t first_cube, Polygon *output) {
+    make_polygons_scalar(data, first_cube, output);
+}
+#endif
+} // namespace
+
+void NormalCubeBatch::reserve(const std::size_t count) {
+    m_positions_x.reserve(count);
+    m_positions_y.reserve(count);
+    m_positions_z.reserve(count);
+    m_sizes.reserve(count);
+    for (auto &indentations : m_indentations) {
+        indentations.reserve(count);
+    }
+}
+
+void NormalCubeBatch::clear() noexcept {
+    m_positions_x.clear();
+    m_positions_y.clear();
+    m_positions_z.clear();
+    m_sizes.clear();
+    for (auto &indentations : m_indentations) {
+        indentations.clear();
+    }
+}
+
+void NormalCubeBatch::push_back(const float size, const glm::vec3 &position,
+                                const std::array<Indentation, Cube::EDGES> &indentations) {
+    m_positions_x.push_back(position.x);
+    m_positions_y.push_back(position.y);
+    m_positions_z.push_back(position.z);
+    m_sizes.push_back(size);
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        m_indentations[edge].push_back(
+            static_cast<std::uint8_t>(indentations[edge].start() | (indentations[edge].end() << 4U)));
+    }
+}
+
+std::size_t NormalCubeBatch::size() const noexcept {
+    return m_sizes.size();
+}
+
+void make_normal_polygons(const NormalCubeBatch &batch, const tools::Span<Polygon> output) {
+    if (output.size() < batch.size() * Cube::POLYGONS) {
+        throw std::invalid_argument("Output is too small for the polygons of the batch.");
+    }
+    BatchData data{{batch.m_positions_x.data(), batch.m_positions_y.data(), batch.m_positions_z.data()},
+                   batch.m_sizes.data(),
+                   {}};
+    for (std::size_t edge = 0; edge < Cube::EDGES; edge++) {
+        data.indentations[edge] = batch.m_indentations[edge].data();
+    }
+
+    std::size_t cube = 0;
+    for (; cube + LANES <= batch.size(); cube += LANES) {
+        make_polygons_simd(data, cube, output.data() + cube * Cube::POLYGONS);
+    }
+    // The remaining cubes do not fill all lanes.
+    for (; cube < batch.size(); cube++) {
+        make_polygons_scalar(data, cube, output.data() + cube * Cube::POLYGONS);
+    }
+}
+
+const char *normal_polygons_instruction_set() noexcept {
+    return INSTRUCTION_SET;
+}
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,218 @@
+#include "inexor/vulkan-renderer/world/flat_octree.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <cassert>
+#include <stdexcept>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+NodeHandle FlatOctree::allocate_block() {
+    if (!m_free_blocks.empty()) {
+        const NodeHandle first_child = m_free_blocks.back();
+        m_free_blocks.pop_back();
+        for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+            m_nodes[first_child + idx] = Node{};
+        }
+        return first_child;
+    }
+    if (m_nodes.size() + Cube::SUB_CUBES >= INVALID_HANDLE) {
+        throw std::runtime_error("Octree node pool is exhausted.");
+    }
+    const auto first_child = static_cast<NodeHandle>(m_nodes.size());
+    m_nodes.resize(m_nodes.size() + Cube::SUB_CUBES);
+    return first_child;
+}
+
+void FlatOctree::release_block(const NodeHandle first_child) {
+    for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        set_type(first_child + static_cast<NodeHandle>(idx), Cube::Type::EMPTY);
+    }
+    m_free_blocks.push_back(first_child);
+}
+
+std::uint32_t FlatOctree::allocate_indentations() {
+    if (!m_free_indentations.empty()) {
+        const std::uint32_t slot = m_free_indentations.back();
+        m_free_indentations.pop_back();
+        m_indentations[slot] = {};
+        return slot;
+    }
+    m_indentations.emplace_back();
+    return static_cast<std::uint32_t>(m_indentations.size() - 1);
+}
+
+void FlatOctree::import_cube(const NodeHandle node, const Cube &cube) {
+    // Handles of the nodes which receive the next cubes in pre-order.
+    std::vector<NodeHandle> handles{node};
+    visit_pre_order(cube, [&](const Cube &current) {
+        const NodeHandle handle = handles.back();
+        handles.pop_back();
+        set_type(handle, current.type());
+        if (current.type() == Cube::Type::NORMAL) {
+            m_indentations[m_nodes[handle].payload] = current.indentations();
+        } else if (current.type() == Cube::Type::OCTANT) {
+            // Reverse order, so the first child is taken next.
+            for (std::size_t idx = Cube::SUB_CUBES; idx-- > 0;) {
+                handles.push_back(m_nodes[handle].payload + static_cast<NodeHandle>(idx));
+            }
+        }
+    });
+}
+
+void FlatOctree::export_cube(const NodeHandle node, Cube &cube) const {
+    // Handles of the nodes which are copied into the next cubes in pre-order.
+    std::vector<NodeHandle> handles{node};
+    visit_pre_order(cube, [&](Cube &current) {
+        const Node &source = m_nodes[handles.back()];
+        handles.pop_back();
+        current.set_type(source.type);
+        if (source.type == Cube::Type::NORMAL) {
+            const std::array<Indentation, Cube::EDGES> &indentations = m_indentations[source.payload];
+            for (std::uint8_t edge_id = 0; edge_id < Cube::EDGES; edge_id++) {
+                current.set_indent(edge_id, indentations[edge_id]);
+            }
+        } else if (source.type == Cube::Type::OCTANT) {
+            for (std::size_t idx = Cube::SUB_CUBES; idx-- > 0;) {
+                handles.push_back(source.payload + static_cast<NodeHandle>(idx));
+            }
+        }
+    });
+}
+
+FlatOctree::FlatOctree(const Cube::Type type, const float size, const glm::vec3 &position)
+    : m_size(size), m_position(position), m_nodes(1) {
+    set_type(ROOT, type);
+}
+
+FlatOctree::FlatOctree(const Cube &cube) : m_size(cube.size()), m_position(cube.position()), m_nodes(1) {
+    const std::size_t geometry_cubes = cube.count_geometry_cubes();
+    m_nodes.reserve(geometry_cubes * 8 / 7 + Cube::SUB_CUBES);
+    import_cube(ROOT, cube);
+}
+
+std::shared_ptr<Cube> FlatOctree::to_cube() const {
+    auto cube = std::make_shared<Cube>(Cube::Type::SOLID, m_size, m_position);
+    export_cube(ROOT, *cube);
+    return cube;
+}
+
+float FlatOctree::size() const noexcept {
+    return m_size;
+}
+
+glm::vec3 FlatOctree::position() const noexcept {
+    return m_position;
+}
+
+const FlatOctree::Node &FlatOctree::node(const NodeHandle handle) const {
+    assert(handle < m_nodes.size());
+    return m_nodes[handle];
+}
+
+NodeHandle FlatOctree::child(const NodeHandle handle, const std::size_t idx) const {
+    assert(m_nodes[handle].type == Cube::Type::OCTANT);
+    assert(idx < Cube::SUB_CUBES);
+    return m_nodes[handle].payload + static_cast<NodeHandle>(idx);
+}
+
+Cube::Type FlatOctree::type(const NodeHandle handle) const {
+    return node(handle).type;
+}
+
+void FlatOctree::set_type(const NodeHandle handle, const Cube::Type new_type) {
+    assert(handle < m_nodes.size());
+    const Node old_node = m_nodes[handle];
+    if (old_node.type == new_type) {
+        return;
+    }
+    if (old_node.type == Cube::Type::OCTANT) {
+        release_block(old_node.payload);
+    } else if (old_node.type == Cube::Type::NORMAL) {
+        m_free_indentations.push_back(old_node.payload);
+    }
+
+    std::uint32_t payload = INVALID_HANDLE;
+    if (new_type == Cube::Type::OCTANT) {
+        payload = allocate_block();
+    } else if (new_type == Cube::Type::NORMAL) {
+        payload = allocate_indentations();
+    }
+    // Don't hold a reference over the allocation, the pool might have been reallocated.
+    m_nodes[handle] = Node{new_type, payload};
+}
+
+const std::array<Indentation, Cube::EDGES> &FlatOctree::indentations(const NodeHandle handle) const {
+    assert(type(handle) == Cube::Type::NORMAL);
+    return m_indentations[m_nodes[handle].payload];
+}
+
+void FlatOctree::set_indent(const NodeHandle handle, const std::uint8_t edge_id, const Indentation indentation) {
+    if (type(handle) != Cube::Type::NORMAL) {
+        return;
+    }
+    assert(edge_id < Cube::EDGES);
+    m_indentations[m_nodes[handle].payload][edge_id] = indentation;
+}
+
+void FlatOctree::set_indentations(const NodeHandle handle, const std::array<Indentation, Cube::EDGES> &indentations) {
+    if (type(handle) != Cube::Type::NORMAL) {
+        return;
+    }
+    m_indentations[m_nodes[handle].payload] = indentations;
+}
+
+std::size_t FlatOctree::node_count() const noexcept {
+    return m_nodes.size() - m_free_blocks.size() * Cube::SUB_CUBES;
+}
+
+std::size_t FlatOctree::count_geometry_cubes() const {
+    // Released nodes are always Type::EMPTY, so a linear scan over the pool is enough.
+    std::size_t count = 0;
+    for (const Node &node : m_nodes) {
+        count += node.type == Cube::Type::SOLID || node.type == Cube::Type::NORMAL ? 1 : 0;
+    }
+    return count;
+}
+
+std::size_t FlatOctree::memory_usage() const noexcept {
+    return sizeof(FlatOctree) + m_nodes.capacity() * sizeof(Node) +
+           m_indentations.capacity() * sizeof(std::array<Indentation, Cube::EDGES>) +
+           m_free_blocks.capacity() * sizeof(NodeHandle) + m_free_indentations.capacity() * sizeof(std::uint32_t);
+}
+
+std::vector<Polygon> FlatOctree::polygons() const {
+    struct Entry {
+        NodeHandle handle;
+        float size;
+        glm::vec3 position;
+    };
+
+    std::vector<Polygon> polygons;
+    polygons.reserve(count_geometry_cubes() * Cube::POLYGONS);
+    std::vector<Entry> stack{{ROOT, m_size, m_position}};
+    // pre-order traversal, children are pushed in reverse order to be visited in ascending order
+    while (!stack.empty()) {
+        const Entry entry = stack.back();
+        stack.pop_back();
+        const Node &current = m_nodes[entry.handle];
+        if (current.type == Cube::Type::OCTANT) {
+            const float half_size = entry.size / 2;
+            for (std::size_t idx = Cube::SUB_CUBES; idx-- > 0;) {
+                // about the order look into the octree documentation
+                const glm::vec3 offset{(idx & 4U) != 0 ? half_size : 0.0F, (idx & 2U) != 0 ? half_size : 0.0F,
+                                       (idx & 1U) != 0 ? half_size : 0.0F};
+                stack.push_back({current.payload + static_cast<NodeHandle>(idx), half_size, entry.position + offset});
+            }
+            continue;
+        }
+        if (current.type == Cube::Type::EMPTY) {
+            continue;
+        }
+        const auto cube_polygons = Cube::make_polygons(
+            current.type, entry.size, entry.position,
+            current.type == Cube::Type::NORMAL ? m_indentations[current.payload] : std::array<Indentation, 12>{});
+        polygons.insert(polygons.end(), cube_polygons.begin(), cube_polygons.end());
+    }
+    return polygons;
+}
+} // namespace inexor::vulkan_renderer::world
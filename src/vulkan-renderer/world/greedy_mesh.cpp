@@ -0,0 +1,134 @@
+#include "inexor/vulkan-renderer/world/greedy_mesh.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <algorithm>
+#include <map>
+#include <tuple>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+/// Axis aligned rectangle on a plane, u and v are the two axes following the plane normal.
+struct Rectangle {
+    float u_min;
+    float v_min;
+    float u_max;
+    float v_max;
+};
+
+/// Plane of a face: axis of the normal, direction of the normal and the position on the axis.
+using Plane = std::tuple<std::size_t, bool, float>;
+
+void emit_rectangle(const Plane &plane, const Rectangle &rectangle, const std::array<Polygon, Cube::POLYGONS> &unit,
+                    std::vector<Polygon> &polygons) {
+    const auto [axis, positive_direction, position] = plane;
+    const std::size_t u_axis = (axis + 1) % 3;
+    const std::size_t v_axis = (axis + 2) % 3;
+    // The face of the unit cube has the right winding, so it is just stretched onto the rectangle.
+    const std::size_t face = 2 * axis + (positive_direction ? 1 : 0);
+    for (std::size_t idx = 2 * face; idx < 2 * face + 2; idx++) {
+        Polygon polygon = unit[idx];
+        for (auto &vertex : polygon) {
+            vertex[axis] = position;
+            vertex[u_axis] = vertex[u_axis] == 0.0F ? rectangle.u_min : rectangle.u_max;
+            vertex[v_axis] = vertex[v_axis] == 0.0F ? rectangle.v_min : rectangle.v_max;
+        }
+        polygons.push_back(polygon);
+    }
+}
+
+/// Merge the rectangles of a plane. The rectangles must not overlap.
+void merge_rectangles(const Plane &plane, const std::vector<Rectangle> &rectangles,
+                      const std::array<Polygon, Cube::POLYGONS> &unit, std::vector<Polygon> &polygons) {
+    // Compress the coordinates to the borders of the rectangles, so cubes of any level share one grid.
+    std::vector<float> us;
+    std::vector<float> vs;
+    for (const auto &rectangle : rectangles) {
+        us.insert(us.end(), {rectangle.u_min, rectangle.u_max});
+        vs.insert(vs.end(), {rectangle.v_min, rectangle.v_max});
+    }
+    std::sort(us.begin(), us.end());
+    us.erase(std::unique(us.begin(), us.end()), us.end());
+    std::sort(vs.begin(), vs.end());
+    vs.erase(std::unique(vs.begin(), vs.end()), vs.end());
+
+    const auto index_of = [](const std::vector<float> &values, const float value) {
+        return static_cast<std::size_t>(std::lower_bound(values.begin(), values.end(), value) - values.begin());
+    };
+    const std::size_t columns = us.size() - 1;
+    const std::size_t rows = vs.size() - 1;
+    std::vector<bool> covered(columns * rows, false);
+    for (const auto &rectangle : rectangles) {
+        const std::size_t u_end = index_of(us, rectangle.u_max);
+        const std::size_t v_end = index_of(vs, rectangle.v_max);
+        for (std::size_t v = index_of(vs, rectangle.v_min); v < v_end; v++) {
+            for (std::size_t u = index_of(us, rectangle.u_min); u < u_end; u++) {
+                covered[v * columns + u] = true;
+            }
+        }
+    }
+
+    for (std::size_t v = 0; v < rows; v++) {
+        for (std::size_t u = 0; u < columns; u++) {
+            if (!covered[v * columns + u]) {
+                continue;
+            }
+            std::size_t width = 1;
+            while (u + width < columns && covered[v * columns + u + width]) {
+                width++;
+            }
+            std::size_t height = 1;
+            const auto row_covered = [&](const std::size_t row) {
+                return std::all_of(covered.begin() + row * columns + u, covered.begin() + row * columns + u + width,
+                                   [](const bool value) { return value; });
+            };
+            while (v + height < rows && row_covered(v + height)) {
+                height++;
+            }
+            for (std::size_t row = v; row < v + height; row++) {
+                std::fill_n(covered.begin() + row * columns + u, width, false);
+            }
+            emit_rectangle(plane, {us[u], vs[v], us[u + width], vs[v + height]}, unit, polygons);
+        }
+    }
+}
+} // namespace
+
+std::vector<Polygon> greedy_mesh(const Cube &root) {
+    std::vector<Polygon> polygons;
+    std::map<Plane, std::vector<Rectangle>> planes;
+
+    visit_leaves(root, [&](const Cube &cube) {
+        if (cube.type() == Cube::Type::NORMAL) {
+            if (!cube.m_polygon_cache_valid) {
+                cube.update_polygon_cache();
+            }
+            const PolygonCache cache = cube.polygon_cache();
+            polygons.insert(polygons.end(), cache.begin(), cache.end());
+            return;
+        }
+        if (cube.type() != Cube::Type::SOLID) {
+            return;
+        }
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            const std::size_t u_axis = (axis + 1) % 3;
+            const std::size_t v_axis = (axis + 2) % 3;
+            for (const bool positive_direction : {false, true}) {
+                if (cube.is_face_hidden(axis, positive_direction)) {
+                    continue;
+                }
+                const glm::vec3 position = cube.position();
+                const float plane_position = position[axis] + (positive_direction ? cube.size() : 0.0F);
+                planes[{axis, positive_direction, plane_position}].push_back(
+                    {position[u_axis], position[v_axis], position[u_axis] + cube.size(),
+                     position[v_axis] + cube.size()});
+            }
+        }
+    });
+
+    const auto unit = Cube::make_polygons(Cube::Type::SOLID, 1.0F, {0.0F, 0.0F, 0.0F}, {});
+    for (const auto &[plane, rectangles] : planes) {
+        merge_rectangles(plane, rectangles, unit, polygons);
+    }
+    return polygons;
+}
+} // namespace inexor::vulkan_renderer::world
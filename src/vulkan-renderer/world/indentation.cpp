@@ -3,23 +3,49 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
-#include <cmath>
 
 namespace inexor::vulkan_renderer::world {
+namespace {
+
+/// Conversion between uids and indentations, the uids are ordered by start and then by end.
+struct UidTables {
+    /// Start and end of each uid, covering all six bit values. Invalid uids are mapped to the default indentation.
+    std::array<std::uint8_t, 64> starts{};
+    std::array<std::uint8_t, 64> ends{};
+    /// Uid of each start and end.
+    std::array<std::array<std::uint8_t, Indentation::MAX + 1>, Indentation::MAX + 1> uids{};
+};
+
+constexpr UidTables make_uid_tables() {
+    UidTables tables;
+    for (std::size_t uid = 0; uid < tables.starts.size(); uid++) {
+        tables.ends[uid] = Indentation::MAX;
+    }
+    std::uint8_t uid = 0;
+    for (std::uint8_t start = 0; start <= Indentation::MAX; start++) {
+        for (std::uint8_t end = start; end <= Indentation::MAX; end++) {
+            tables.starts[uid] = start;
+            tables.ends[uid] = end;
+            tables.uids[start][end] = uid++;
+        }
+    }
+    return tables;
+}
+
+constexpr UidTables UID_TABLES = make_uid_tables();
+
+static_assert(UID_TABLES.uids[Indentation::MAX][Indentation::MAX] == Indentation::UID_COUNT - 1);
+// uid = 10 * start + (end - start) - (start^2 + start) / 2, as used by the octree format.
+static_assert(UID_TABLES.uids[3][5] == 10 * 3 + 2 - (9 + 3) / 2);
+
+} // namespace
+
 Indentation::Indentation(const std::uint8_t start, const std::uint8_t end) noexcept : m_start(start), m_end(end) {}
 
 Indentation::Indentation(const std::uint8_t uid) noexcept {
-    assert(uid <= 44);
-    constexpr std::array<std::uint8_t, Indentation::MAX> masks{44, 42, 39, 35, 30, 24, 17, 9};
-    for (std::uint8_t idx = 0; idx < Indentation::MAX; idx++) {
-        if (masks[idx] <= uid) {
-            m_start = Indentation::MAX - idx;
-            m_end = m_start + (uid - masks[idx]);
-            return;
-        }
-    }
-    m_start = 0;
-    m_end = uid;
+    assert(uid < UID_COUNT);
+    m_start = UID_TABLES.starts[uid & 0b00111111U];
+    m_end = UID_TABLES.ends[uid & 0b00111111U];
 }
 
 bool Indentation::operator==(const Indentation &rhs) const {
@@ -75,6 +101,36 @@ void Indentation::mirror() noexcept {
 }
 
 std::uint8_t Indentation::uid() const {
-    return static_cast<std::uint8_t>(10 * m_start + offset() - (std::pow(m_start, 2) + m_start) / 2);
+    assert(m_start <= m_end && m_end <= MAX);
+    return UID_TABLES.uids[m_start][m_end];
+}
+
+std::array<std::uint8_t, Indentation::PACKED_EDGES_SIZE>
+Indentation::pack(const std::array<Indentation, 12> &indentations) noexcept {
+    std::array<std::uint8_t, PACKED_EDGES_SIZE> bytes{};
+    // Four uids of six bits fit into three bytes.
+    for (std::size_t group = 0; group < 3; group++) {
+        std::uint32_t bits = 0;
+        for (std::size_t idx = 0; idx < 4; idx++) {
+            bits = (bits << 6U) | indentations[group * 4 + idx].uid();
+        }
+        bytes[group * 3] = static_cast<std::uint8_t>(bits >> 16U);
+        bytes[group * 3 + 1] = static_cast<std::uint8_t>(bits >> 8U);
+        bytes[group * 3 + 2] = static_cast<std::uint8_t>(bits);
+    }
+    return bytes;
+}
+
+std::array<Indentation, 12> Indentation::unpack(const std::array<std::uint8_t, PACKED_EDGES_SIZE> &bytes) noexcept {
+    std::array<Indentation, 12> indentations;
+    for (std::size_t group = 0; group < 3; group++) {
+        const std::uint32_t bits = (static_cast<std::uint32_t>(bytes[group * 3]) << 16U) |
+                                   (static_cast<std::uint32_t>(bytes[group * 3 + 1]) << 8U) | bytes[group * 3 + 2];
+        for (std::size_t idx = 0; idx < 4; idx++) {
+            const std::uint32_t uid = (bits >> (18U - 6U * idx)) & 0b00111111U;
+            indentations[group * 4 + idx] = Indentation(UID_TABLES.starts[uid], UID_TABLES.ends[uid]);
+        }
+    }
+    return indentations;
 }
 } // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,86 @@
+#include "inexor/vulkan-renderer/world/octree_dag.hpp"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+void hash_combine(std::size_t &seed, const std::size_t value) noexcept {
+    seed ^= value + 0x9e3779b9U + (seed << 6U) + (seed >> 2U);
+}
+} // namespace
+
+std::size_t OctreeDag::NodeHash::operator()(const SnapshotNode *node) const noexcept {
+    auto seed = static_cast<std::size_t>(node->type);
+    if (node->type == Cube::Type::NORMAL) {
+        for (const auto &indentation : node->indentations) {
+            hash_combine(seed, indentation.uid());
+        }
+    } else if (node->type == Cube::Type::OCTANT) {
+        for (const auto &child : node->childs) {
+            hash_combine(seed, std::hash<const SnapshotNode *>{}(child.get()));
+        }
+    }
+    return seed;
+}
+
+bool OctreeDag::NodeEqual::operator()(const SnapshotNode *lhs, const SnapshotNode *rhs) const noexcept {
+    if (lhs->type != rhs->type) {
+        return false;
+    }
+    switch (lhs->type) {
+    case Cube::Type::NORMAL:
+        return lhs->indentations == rhs->indentations;
+    case Cube::Type::OCTANT:
+        return lhs->childs == rhs->childs;
+    default:
+        return true;
+    }
+}
+
+std::shared_ptr<const SnapshotNode> OctreeDag::intern(SnapshotNode node) {
+    const auto iter = m_nodes.find(&node);
+    if (iter != m_nodes.end()) {
+        return iter->second;
+    }
+    auto unique_node = std::make_shared<const SnapshotNode>(std::move(node));
+    m_nodes.emplace(unique_node.get(), unique_node);
+    return unique_node;
+}
+
+OctreeSnapshot OctreeDag::deduplicate(const OctreeSnapshot &snapshot) {
+    // Unique node of every node of the snapshot which has been merged already.
+    std::unordered_map<const SnapshotNode *, std::shared_ptr<const SnapshotNode>> merged;
+    // Post-order traversal, octants are visited a second time after their children have been merged.
+    std::vector<std::pair<const SnapshotNode *, bool>> stack{{snapshot.root().get(), false}};
+    while (!stack.empty()) {
+        const auto [node, childs_merged] = stack.back();
+        stack.pop_back();
+        if (merged.find(node) != merged.end()) {
+            continue;
+        }
+        if (node->type != Cube::Type::OCTANT) {
+            merged.emplace(node, intern(SnapshotNode{node->type, node->indentations}));
+            continue;
+        }
+        if (!childs_merged) {
+            stack.emplace_back(node, true);
+            for (const auto &child : node->childs) {
+                stack.emplace_back(child.get(), false);
+            }
+            continue;
+        }
+        SnapshotNode octant{Cube::Type::OCTANT};
+        for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+            octant.childs[idx] = merged.at(node->childs[idx].get());
+        }
+        merged.emplace(node, intern(std::move(octant)));
+    }
+    return {snapshot.size(), snapshot.position(), merged.at(snapshot.root().get())};
+}
+
+std::size_t OctreeDag::node_count() const noexcept {
+    return m_nodes.size();
+}
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,113 @@
+#include "inexor/vulkan-renderer/world/octree_edit_batch.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <unordered_set>
+
+namespace inexor::vulkan_renderer::world {
+OctreeEditBatch::Edit &OctreeEditBatch::edit(const std::shared_ptr<Cube> &cube) {
+    assert(cube != nullptr);
+    const auto [iter, inserted] = m_edit_indices.try_emplace(cube.get(), m_edits.size());
+    if (inserted) {
+        m_edits.push_back({cube, cube->m_type, cube->m_indentations});
+    }
+    return m_edits[iter->second];
+}
+
+void OctreeEditBatch::set_type(const std::shared_ptr<Cube> &cube, const Cube::Type new_type) {
+    Edit &pending = edit(cube);
+    if (pending.type != new_type && new_type == Cube::Type::NORMAL) {
+        pending.indentations = {};
+    }
+    pending.type = new_type;
+}
+
+void OctreeEditBatch::set_indent(const std::shared_ptr<Cube> &cube, const std::uint8_t edge_id,
+                                 const Indentation indentation) {
+    assert(edge_id < Cube::EDGES);
+    Edit &pending = edit(cube);
+    if (pending.type == Cube::Type::NORMAL) {
+        pending.indentations[edge_id] = indentation;
+    }
+}
+
+void OctreeEditBatch::indent(const std::shared_ptr<Cube> &cube, const std::uint8_t edge_id,
+                             const bool positive_direction, const std::uint8_t steps) {
+    assert(edge_id < Cube::EDGES);
+    Edit &pending = edit(cube);
+    if (pending.type != Cube::Type::NORMAL) {
+        return;
+    }
+    if (positive_direction) {
+        pending.indentations[edge_id].indent_start(steps);
+    } else {
+        pending.indentations[edge_id].indent_end(steps);
+    }
+}
+
+std::size_t OctreeEditBatch::size() const noexcept {
+    return m_edits.size();
+}
+
+bool OctreeEditBatch::empty() const noexcept {
+    return m_edits.empty();
+}
+
+std::vector<std::shared_ptr<Cube>> OctreeEditBatch::commit() {
+    std::vector<std::shared_ptr<Cube>> changed_cubes;
+    changed_cubes.reserve(m_edits.size());
+    // Apply all edits first, so the neighbours are looked up in the final octree.
+    for (Edit &pending : m_edits) {
+        Cube &cube = *pending.cube;
+        bool changed = cube.m_type != pending.type;
+        cube.apply_type(pending.type);
+        if (pending.type == Cube::Type::NORMAL && cube.m_indentations != pending.indentations) {
+            cube.m_indentations = pending.indentations;
+            changed = true;
+        }
+        if (changed) {
+            changed_cubes.push_back(std::move(pending.cube));
+        }
+    }
+    m_edits.clear();
+    m_edit_indices.clear();
+
+    const auto is_removed = [](const std::shared_ptr<Cube> &cube) { return !cube->is_attached(); };
+    changed_cubes.erase(std::remove_if(changed_cubes.begin(), changed_cubes.end(), is_removed), changed_cubes.end());
+    if (changed_cubes.empty()) {
+        return changed_cubes;
+    }
+
+    for (const auto &cube : changed_cubes) {
+        cube->invalidate_snapshot();
+        cube->mark_dirty();
+    }
+    // Changed cubes are dirty already, only the faces of the other neighbours have to be marked.
+    std::unordered_set<const Cube *> changed_set;
+    changed_set.reserve(changed_cubes.size());
+    for (const auto &cube : changed_cubes) {
+        changed_set.insert(cube.get());
+    }
+    for (const auto &cube : changed_cubes) {
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            for (const bool positive_direction : {false, true}) {
+                const Cube *neighbour = cube->neighbour(axis, positive_direction);
+                if (neighbour != nullptr && changed_set.count(neighbour) == 0) {
+                    neighbour->mark_face_dirty(axis, !positive_direction);
+                }
+            }
+        }
+    }
+
+    if (changed_cubes.front()->root_cube().m_auto_compact) {
+        for (const auto &cube : changed_cubes) {
+            if ((cube->m_type == Cube::Type::EMPTY || cube->m_type == Cube::Type::SOLID) && cube->is_attached()) {
+                cube->collapse_ancestors();
+            }
+        }
+        changed_cubes.erase(std::remove_if(changed_cubes.begin(), changed_cubes.end(), is_removed),
+                            changed_cubes.end());
+    }
+    return changed_cubes;
+}
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,165 @@
+#include "inexor/vulkan-renderer/world/octree_lod.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace inexor::vulkan_renderer::world {
+OctreeLod::OctreeLod(const float detail_factor) : m_detail_factor(detail_factor) {
+    assert(detail_factor > 0);
+}
+
+float OctreeLod::solid_fraction(const SnapshotNode &node,
+                                std::unordered_map<const SnapshotNode *, float> &previous_fractions) {
+    if (const auto iter = m_solid_fractions.find(&node); iter != m_solid_fractions.end()) {
+        return iter->second;
+    }
+    if (const auto iter = previous_fractions.find(&node); iter != previous_fractions.end()) {
+        m_solid_fractions.insert(*iter);
+        return iter->second;
+    }
+    // Every entry holds the share of the cube in the volume of the node.
+    float fraction = 0.0F;
+    std::vector<std::pair<const SnapshotNode *, float>> stack{{&node, 1.0F}};
+    while (!stack.empty()) {
+        const auto [current, volume] = stack.back();
+        stack.pop_back();
+        switch (current->type) {
+        case Cube::Type::EMPTY:
+            break;
+        case Cube::Type::SOLID:
+        case Cube::Type::NORMAL:
+            fraction += volume;
+            break;
+        case Cube::Type::OCTANT:
+            for (const auto &child : current->childs) {
+                stack.emplace_back(child.get(), volume / Cube::SUB_CUBES);
+            }
+            break;
+        }
+    }
+    m_solid_fractions.emplace(&node, fraction);
+    return fraction;
+}
+
+bool OctreeLod::borders_left_out_octant(const Cube &cube, const std::size_t axis, const bool positive_direction,
+                                        const std::unordered_map<const Cube *, bool> &drawn) {
+    const Cube *neighbour = cube.neighbour(axis, positive_direction);
+    if (neighbour == nullptr) {
+        return false;
+    }
+    // The neighbour has at least the size of the cube, so it is either part of an octant of the selection or it
+    // contains octants of the selection.
+    for (const Cube *current = neighbour; current != nullptr;) {
+        if (const auto iter = drawn.find(current); iter != drawn.end()) {
+            return !iter->second;
+        }
+        const auto parent = current->m_parent.lock();
+        current = parent.get() != current ? parent.get() : nullptr;
+    }
+    bool left_out = false;
+    visit_pre_order(*neighbour, [&](const Cube &current) {
+        if (left_out || !neighbour->touches_face(current, axis, !positive_direction)) {
+            return false;
+        }
+        if (const auto iter = drawn.find(&current); iter != drawn.end()) {
+            left_out = !iter->second;
+            return false;
+        }
+        return true;
+    });
+    return left_out;
+}
+
+bool OctreeLod::update(const Cube &root, const glm::vec3 &camera_position) {
+    // Only the paths to the cubes changed since the last update get new nodes.
+    OctreeSnapshot snapshot = root.snapshot();
+
+    std::vector<Selection> selection;
+    selection.reserve(m_selection.size());
+    visit_pre_order(root, [&](const Cube &cube) {
+        if (cube.m_type != Cube::Type::OCTANT) {
+            selection.push_back({&cube, cube.m_snapshot.get(), false});
+            return false;
+        }
+        // Distance from the camera to the closest point of the cube.
+        float distance_squared = 0.0F;
+        for (std::size_t axis = 0; axis < 3; axis++) {
+            const float closest = std::clamp(camera_position[axis], cube.m_position[axis],
+                                             cube.m_position[axis] + cube.m_size);
+            distance_squared += (camera_position[axis] - closest) * (camera_position[axis] - closest);
+        }
+        const float detail_distance = cube.m_size * m_detail_factor;
+        if (distance_squared > detail_distance * detail_distance) {
+            selection.push_back({&cube, cube.m_snapshot.get(), true});
+            return false;
+        }
+        return true;
+    });
+
+    // Every edit changes the node of the edited cube and its ancestors, so equal selections have equal polygons.
+    if (selection == m_selection) {
+        return false;
+    }
+
+    std::unordered_map<const SnapshotNode *, float> previous_fractions;
+    std::swap(previous_fractions, m_solid_fractions);
+    std::unordered_map<const Cube *, bool> drawn;
+    bool any_left_out = false;
+    for (const Selection &selected : selection) {
+        if (selected.representative) {
+            const bool is_drawn = solid_fraction(*selected.node, previous_fractions) >= 0.5F;
+            drawn.emplace(selected.cube, is_drawn);
+            any_left_out = any_left_out || !is_drawn;
+        }
+    }
+
+    m_polygons.clear();
+    for (const Selection &selected : selection) {
+        const Cube &cube = *selected.cube;
+        if (selected.representative) {
+            if (drawn.at(&cube)) {
+                const auto polygons = Cube::make_polygons(Cube::Type::SOLID, cube.m_size, cube.m_position, {});
+                m_polygons.insert(m_polygons.end(), polygons.begin(), polygons.end());
+            }
+            continue;
+        }
+        if (cube.m_type == Cube::Type::EMPTY) {
+            continue;
+        }
+        if (!cube.m_polygon_cache_valid) {
+            cube.update_polygon_cache();
+        }
+        const PolygonCache polygons = cube.polygon_cache();
+        if (!any_left_out || polygons.size() == Cube::POLYGONS) {
+            m_polygons.insert(m_polygons.end(), polygons.begin(), polygons.end());
+            continue;
+        }
+        // The cache keeps the faces in their order, the missing ones are hidden by neighbours. They are drawn anyway
+        // if the neighbours are part of an octant which is left out.
+        const auto all_polygons = Cube::make_polygons(cube.m_type, cube.m_size, cube.m_position, cube.m_indentations);
+        std::size_t cached = 0;
+        for (std::size_t face = 0; face < 6; face++) {
+            if (cached < polygons.size() && polygons[cached] == all_polygons[2 * face]) {
+                cached += 2;
+            } else if (!borders_left_out_octant(cube, face / 2, face % 2 == 1, drawn)) {
+                continue;
+            }
+            m_polygons.push_back(all_polygons[2 * face]);
+            m_polygons.push_back(all_polygons[2 * face + 1]);
+        }
+    }
+    m_selection = std::move(selection);
+    m_snapshot = std::move(snapshot);
+    return true;
+}
+
+const std::vector<Polygon> &OctreeLod::polygons() const noexcept {
+    return m_polygons;
+}
+
+const std::vector<OctreeLod::Selection> &OctreeLod::selection() const noexcept {
+    return m_selection;
+}
+} // namespace inexor::vulkan_renderer::world
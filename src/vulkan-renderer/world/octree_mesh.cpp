@@ -0,0 +1,126 @@
+#include "inexor/vulkan-renderer/world/octree_mesh.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace inexor::vulkan_renderer::world {
+namespace {
+std::vector<OctreeMesh::PolygonRange> merge_ranges(std::vector<std::uint32_t> &changed_faces) {
+    std::sort(changed_faces.begin(), changed_faces.end());
+    changed_faces.erase(std::unique(changed_faces.begin(), changed_faces.end()), changed_faces.end());
+    std::vector<OctreeMesh::PolygonRange> ranges;
+    for (const std::uint32_t face : changed_faces) {
+        const auto first_polygon = static_cast<std::uint32_t>(face * OctreeMesh::POLYGONS_PER_FACE);
+        if (!ranges.empty() && ranges.back().first + ranges.back().count == first_polygon) {
+            ranges.back().count += OctreeMesh::POLYGONS_PER_FACE;
+        } else {
+            ranges.push_back({first_polygon, OctreeMesh::POLYGONS_PER_FACE});
+        }
+    }
+    return ranges;
+}
+} // namespace
+
+std::uint32_t OctreeMesh::allocate_range(const std::size_t faces) {
+    assert(faces > 0 && faces <= FACES);
+    if (auto &free_ranges = m_free_ranges[faces - 1]; !free_ranges.empty()) {
+        const std::uint32_t first_face = free_ranges.back();
+        free_ranges.pop_back();
+        return first_face;
+    }
+    if (m_range_faces.size() + faces >= Cube::NO_MESH_SLOT) {
+        throw std::runtime_error("Octree mesh has no free faces left.");
+    }
+    const auto first_face = static_cast<std::uint32_t>(m_range_faces.size());
+    m_range_faces.resize(m_range_faces.size() + faces, 0);
+    m_range_faces[first_face] = static_cast<std::uint8_t>(faces);
+    if (m_range_faces.size() * POLYGONS_PER_FACE > m_polygons.size()) {
+        m_polygons.resize(std::max(m_range_faces.size() * POLYGONS_PER_FACE, m_polygons.size() * 2));
+    }
+    return first_face;
+}
+
+void OctreeMesh::release_range(const std::uint32_t first_face, std::vector<std::uint32_t> &changed_faces) {
+    assert(first_face < m_range_faces.size());
+    const std::uint8_t faces = m_range_faces[first_face];
+    // Degenerated polygons have no surface, so nothing is rendered.
+    std::fill_n(m_polygons.begin() + first_face * POLYGONS_PER_FACE, faces * POLYGONS_PER_FACE, Polygon{});
+    m_free_ranges[faces - 1].push_back(first_face);
+    for (std::uint32_t face = first_face; face < first_face + faces; face++) {
+        changed_faces.push_back(face);
+    }
+}
+
+void OctreeMesh::write_range(const Cube &cube, std::vector<std::uint32_t> &changed_faces) {
+    if (!cube.m_polygon_cache_valid) {
+        cube.update_polygon_cache();
+    }
+    const PolygonCache polygons = cube.polygon_cache();
+    const std::size_t faces = polygons.size() / POLYGONS_PER_FACE;
+    if (cube.m_mesh_slot != Cube::NO_MESH_SLOT && m_range_faces[cube.m_mesh_slot] != faces) {
+        release_range(cube.m_mesh_slot, changed_faces);
+        cube.m_mesh_slot = Cube::NO_MESH_SLOT;
+    }
+    if (faces == 0) {
+        return;
+    }
+    if (cube.m_mesh_slot == Cube::NO_MESH_SLOT) {
+        cube.m_mesh_slot = allocate_range(faces);
+    }
+    std::copy(polygons.begin(), polygons.end(), m_polygons.begin() + cube.m_mesh_slot * POLYGONS_PER_FACE);
+    for (std::uint32_t face = cube.m_mesh_slot; face < cube.m_mesh_slot + faces; face++) {
+        changed_faces.push_back(face);
+    }
+}
+
+std::vector<OctreeMesh::PolygonRange> OctreeMesh::update(const Cube &root) {
+    std::vector<std::uint32_t> changed_faces;
+    // Only subtrees marked as dirty are visited.
+    visit_pre_order(root, [&](const Cube &cube) {
+        if (!cube.m_dirty) {
+            return false;
+        }
+        cube.m_dirty = false;
+
+        for (const std::uint32_t first_face : cube.m_released_mesh_slots) {
+            release_range(first_face, changed_faces);
+        }
+        cube.m_released_mesh_slots.clear();
+
+        if (cube.m_type == Cube::Type::SOLID || cube.m_type == Cube::Type::NORMAL) {
+            write_range(cube, changed_faces);
+            return false;
+        }
+        // Type::EMPTY and Type::OCTANT have no polygons on their own.
+        if (cube.m_mesh_slot != Cube::NO_MESH_SLOT) {
+            release_range(cube.m_mesh_slot, changed_faces);
+            cube.m_mesh_slot = Cube::NO_MESH_SLOT;
+        }
+        return true;
+    });
+
+    return merge_ranges(changed_faces);
+}
+
+std::vector<OctreeMesh::PolygonRange> OctreeMesh::remove(const Cube &root) {
+    std::vector<std::uint32_t> changed_faces;
+    visit_pre_order(root, [&](const Cube &cube) {
+        for (const std::uint32_t first_face : cube.m_released_mesh_slots) {
+            release_range(first_face, changed_faces);
+        }
+        cube.m_released_mesh_slots.clear();
+        if (cube.m_mesh_slot != Cube::NO_MESH_SLOT) {
+            release_range(cube.m_mesh_slot, changed_faces);
+            cube.m_mesh_slot = Cube::NO_MESH_SLOT;
+        }
+        cube.m_dirty = true;
+    });
+    return merge_ranges(changed_faces);
+}
+
+const std::vector<Polygon> &OctreeMesh::polygons() const noexcept {
+    return m_polygons;
+}
+} // namespace inexor::vulkan_renderer::world
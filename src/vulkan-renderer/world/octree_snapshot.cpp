@@ -0,0 +1,96 @@
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+
+#include <cassert>
+#include <unordered_set>
+#include <utility>
+
+namespace inexor::vulkan_renderer::world {
+OctreeSnapshot::OctreeSnapshot(const float size, const glm::vec3 &position, std::shared_ptr<const SnapshotNode> root)
+    : m_size(size), m_position(position), m_root(std::move(root)) {
+    assert(m_root != nullptr);
+}
+
+float OctreeSnapshot::size() const noexcept {
+    return m_size;
+}
+
+glm::vec3 OctreeSnapshot::position() const noexcept {
+    return m_position;
+}
+
+const std::shared_ptr<const SnapshotNode> &OctreeSnapshot::root() const noexcept {
+    return m_root;
+}
+
+std::shared_ptr<Cube> OctreeSnapshot::to_cube() const {
+    auto cube = std::make_shared<Cube>(Cube::Type::SOLID, m_size, m_position);
+    cube->restore(*this);
+    return cube;
+}
+
+std::size_t OctreeSnapshot::count_geometry_cubes() const {
+    std::size_t count = 0;
+    std::vector<const SnapshotNode *> stack{m_root.get()};
+    while (!stack.empty()) {
+        const SnapshotNode *node = stack.back();
+        stack.pop_back();
+        if (node->type == Cube::Type::OCTANT) {
+            for (const auto &child : node->childs) {
+                stack.push_back(child.get());
+            }
+        } else if (node->type != Cube::Type::EMPTY) {
+            count++;
+        }
+    }
+    return count;
+}
+
+std::size_t OctreeSnapshot::count_nodes() const {
+    std::unordered_set<const SnapshotNode *> visited{m_root.get()};
+    std::vector<const SnapshotNode *> stack{m_root.get()};
+    while (!stack.empty()) {
+        const SnapshotNode *node = stack.back();
+        stack.pop_back();
+        for (std::size_t idx = 0; node->type == Cube::Type::OCTANT && idx < Cube::SUB_CUBES; idx++) {
+            if (visited.insert(node->childs[idx].get()).second) {
+                stack.push_back(node->childs[idx].get());
+            }
+        }
+    }
+    return visited.size();
+}
+
+std::vector<Polygon> OctreeSnapshot::polygons() const {
+    struct Entry {
+        const SnapshotNode *node;
+        float size;
+        glm::vec3 position;
+    };
+
+    std::vector<Polygon> polygons;
+    polygons.reserve(count_geometry_cubes() * Cube::POLYGONS);
+    std::vector<Entry> stack{{m_root.get(), m_size, m_position}};
+    // pre-order traversal, children are pushed in reverse order to be visited in ascending order
+    while (!stack.empty()) {
+        const Entry entry = stack.back();
+        stack.pop_back();
+        const SnapshotNode &current = *entry.node;
+        if (current.type == Cube::Type::OCTANT) {
+            const float half_size = entry.size / 2;
+            for (std::size_t idx = Cube::SUB_CUBES; idx-- > 0;) {
+                // about the order look into the octree documentation
+                const glm::vec3 offset{(idx & 4U) != 0 ? half_size : 0.0F, (idx & 2U) != 0 ? half_size : 0.0F,
+                                       (idx & 1U) != 0 ? half_size : 0.0F};
+                stack.push_back({current.childs[idx].get(), half_size, entry.position + offset});
+            }
+            continue;
+        }
+        if (current.type == Cube::Type::EMPTY) {
+            continue;
+        }
+        const auto cube_polygons = Cube::make_polygons(current.type, entry.size, entry.position, current.indentations);
+        polygons.insert(polygons.end(), cube_polygons.begin(), cube_polygons.end());
+    }
+    return polygons;
+}
+} // namespace inexor::vulkan_renderer::world
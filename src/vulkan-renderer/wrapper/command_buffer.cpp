@@ -55,9 +55,8 @@ void CommandBuffer::bind_graphics_pipeline(VkPipeline pipeline) const {
     vkCmdBindPipeline(m_command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
 }
 
-void CommandBuffer::bind_index_buffer(VkBuffer buffer) const {
-    // TODO: Don't hardcode 16 for index bit width here.
-    vkCmdBindIndexBuffer(m_command_buffer, buffer, 0, VK_INDEX_TYPE_UINT16);
+void CommandBuffer::bind_index_buffer(VkBuffer buffer, const VkIndexType index_type) const {
+    vkCmdBindIndexBuffer(m_command_buffer, buffer, 0, index_type);
 }
 
 void CommandBuffer::bind_vertex_buffers(const std::vector<VkBuffer> &buffers) const {
@@ -0,0 +1,85 @@
+#include "../world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/mapped_file.hpp"
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
+#include "inexor/vulkan-renderer/tools/span.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace inexor::vulkan_renderer::io {
+
+namespace {
+
+/// Write the bytes into a file in the temporary directory.
+std::filesystem::path write_temporary_file(const std::string &name, const std::vector<std::uint8_t> &bytes) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream file(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char *>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    return path;
+}
+
+std::vector<std::uint8_t> to_vector(const tools::Span<const std::uint8_t> span) {
+    return {span.begin(), span.end()};
+}
+
+} // namespace
+
+TEST(ByteStream, MappedFileHasTheSameBytesAsTheReadFile) {
+    // Larger than a page, and not a multiple of the page size.
+    std::vector<std::uint8_t> bytes(100003);
+    for (std::size_t idx = 0; idx < bytes.size(); idx++) {
+        bytes[idx] = static_cast<std::uint8_t>(idx * 31 % 251);
+    }
+    const auto path = write_temporary_file("inexor_test_byte_stream.bin", bytes);
+
+    {
+        const ByteStream stream(path);
+        EXPECT_EQ(stream.is_mapped(), MappedFile::SUPPORTED);
+        EXPECT_EQ(to_vector(stream.data()), bytes);
+        EXPECT_EQ(to_vector(stream.data()), to_vector(ByteStream::read_from_file(path).data()));
+        if constexpr (MappedFile::SUPPORTED) {
+            EXPECT_EQ(to_vector(MappedFile(path).data()), bytes);
+            // Copies share the mapping instead of copying the bytes.
+            const ByteStream copy = stream;
+            EXPECT_EQ(copy.data().data(), stream.data().data());
+        }
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ByteStream, OctreeIsDeserializedFromMappedFile) {
+    const auto octree = tests::generate_octree(4);
+    const auto path = write_temporary_file("inexor_test_byte_stream.nxoc", to_vector(serialize_octree(octree).data()));
+    EXPECT_EQ(tests::collect_polygons(*deserialize_octree(ByteStream(path))), tests::collect_polygons(*octree));
+    std::filesystem::remove(path);
+}
+
+TEST(ByteStream, EmptyFileIsAnEmptyStream) {
+    const auto path = write_temporary_file("inexor_test_byte_stream_empty.bin", {});
+    EXPECT_EQ(ByteStream(path).size(), 0);
+    EXPECT_EQ(ByteStream::read_from_file(path).size(), 0);
+    if constexpr (MappedFile::SUPPORTED) {
+        EXPECT_TRUE(MappedFile(path).data().empty());
+    }
+    std::filesystem::remove(path);
+}
+
+TEST(ByteStream, MissingFileFallsBackToAnEmptyStream) {
+    const auto path = std::filesystem::temp_directory_path() / "inexor_test_byte_stream_missing.bin";
+    std::filesystem::remove(path);
+    const ByteStream stream(path);
+    EXPECT_FALSE(stream.is_mapped());
+    EXPECT_EQ(stream.size(), 0);
+    EXPECT_EQ(ByteStream::read_from_file(path).size(), 0);
+    EXPECT_THROW(MappedFile{path}, std::runtime_error);
+}
+
+} // namespace inexor::vulkan_renderer::io
@@ -0,0 +1,41 @@
+#include "../world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/mesh_cache.hpp"
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tests {
+
+TEST(MeshCache, StoredMeshIsLoadedOnlyWithItsKey) {
+    const auto directory = std::filesystem::temp_directory_path() / "inexor_test_mesh_cache";
+    std::filesystem::remove_all(directory);
+    const io::MeshCache cache(directory);
+
+    const auto octree = io::serialize_octree(generate_octree(3), 0);
+    const std::uint64_t key = io::MeshCache::key(octree.data());
+    EXPECT_EQ(io::MeshCache::key(octree.data()), key);
+    EXPECT_NE(io::MeshCache::key(octree.data(), 1), key);
+    EXPECT_NE(io::MeshCache::key(io::serialize_octree(generate_octree(3, 7), 0).data()), key);
+
+    const std::vector<OctreeGpuVertex> vertices{{{0.0F, 0.0F, 0.0F}, {1.0F, 0.0F, 0.0F}},
+                                                {{1.0F, 0.0F, 0.0F}, {0.0F, 1.0F, 0.0F}},
+                                                {{0.0F, 1.0F, 0.0F}, {0.0F, 0.0F, 1.0F}}};
+    const std::vector<std::uint32_t> indices{0, 1, 2, 2, 1, 0};
+    cache.store("world", key, vertices, indices);
+
+    const auto mesh = cache.load("world", key);
+    ASSERT_TRUE(mesh.has_value());
+    EXPECT_EQ(mesh->vertices, vertices);
+    EXPECT_EQ(mesh->indices, indices);
+    EXPECT_FALSE(cache.load("world", key + 1).has_value());
+    EXPECT_FALSE(cache.load("other", key).has_value());
+    std::filesystem::remove_all(directory);
+}
+
+} // namespace inexor::vulkan_renderer::tests
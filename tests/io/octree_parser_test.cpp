@@ -0,0 +1,314 @@
+#include "../world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/io/byte_sink.hpp"
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/octree_index.hpp"
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/flat_octree.hpp"
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tests {
+
+namespace {
+
+/// The bytes of an octree in version 0, which has a single representation for every octree.
+std::vector<std::uint8_t> octree_bytes(const std::shared_ptr<const world::Cube> &cube) {
+    const auto stream = io::serialize_octree(cube, 0);
+    return {stream.data().begin(), stream.data().end()};
+}
+
+/// An octree of version 3 with the given number of cubes, which has to be one more than a multiple of eight. It is
+/// made of full octants, whose leaves all have the same depth. The full octant of every depth is written once and
+/// referred to afterwards, so even octrees with millions of cubes take only a few hundred bytes.
+io::ByteStream deduplicated_octree(const std::uint64_t cube_count) {
+    constexpr auto OCTANT = static_cast<std::uint8_t>(world::Cube::Type::OCTANT);
+    constexpr auto SOLID = static_cast<std::uint8_t>(world::Cube::Type::SOLID);
+    constexpr std::uint8_t REFERENCE_RECORD = 4;
+
+    const auto header = io::serialize_octree(std::make_shared<world::Cube>(world::Cube::Type::SOLID), 3);
+    std::vector<std::uint8_t> bytes(header.data().begin(), header.data().end() - 1);
+    // Octants are numbered in the order of their records, references use these numbers.
+    std::uint32_t next_index = 0;
+    std::vector<std::uint32_t> full_octants;
+    const auto full_cube_count = [](const std::size_t depth) {
+        std::uint64_t count = 1;
+        for (std::size_t level = 0; level <= depth; level++) {
+            count = 1 + world::Cube::SUB_CUBES * count;
+        }
+        return count;
+    };
+
+    std::function<void(std::size_t)> write_full_octant = [&](const std::size_t depth) {
+        if (depth < full_octants.size()) {
+            const std::uint32_t index = full_octants[depth];
+            // The index follows in big endian.
+            bytes.insert(bytes.end(), {REFERENCE_RECORD, static_cast<std::uint8_t>(index >> 24U),
+                                       static_cast<std::uint8_t>(index >> 16U), static_cast<std::uint8_t>(index >> 8U),
+                                       static_cast<std::uint8_t>(index)});
+            return;
+        }
+        bytes.push_back(OCTANT);
+        const std::uint32_t index = next_index++;
+        for (std::size_t idx = 0; idx < world::Cube::SUB_CUBES; idx++) {
+            if (depth == 0) {
+                bytes.push_back(SOLID);
+            } else {
+                write_full_octant(depth - 1);
+            }
+        }
+        full_octants.push_back(index);
+    };
+
+    // The first seven childs are the largest full octants which leave at least one cube for every following child,
+    // the last child takes the rest.
+    std::function<void(std::uint64_t)> write_octree = [&](const std::uint64_t count) {
+        if (count == 1) {
+            bytes.push_back(SOLID);
+            return;
+        }
+        bytes.push_back(OCTANT);
+        next_index++;
+        std::uint64_t rest = count - 1;
+        for (std::size_t idx = 0; idx + 1 < world::Cube::SUB_CUBES; idx++) {
+            const std::uint64_t available = rest - (world::Cube::SUB_CUBES - 1 - idx);
+            if (available < full_cube_count(0)) {
+                bytes.push_back(SOLID);
+                rest--;
+                continue;
+            }
+            std::size_t depth = 0;
+            while (full_cube_count(depth + 1) <= available) {
+                depth++;
+            }
+            write_full_octant(depth);
+            rest -= full_cube_count(depth);
+        }
+        write_octree(rest);
+    };
+    write_octree(cube_count);
+    return io::ByteStream(bytes);
+}
+
+/// Sink which collects the written blocks in memory.
+class MemorySink : public io::ByteSink {
+public:
+    std::vector<std::vector<std::uint8_t>> blocks;
+    bool flushed{false};
+
+    void write_bytes(const tools::Span<const std::uint8_t> bytes) override {
+        blocks.emplace_back(bytes.begin(), bytes.end());
+    }
+
+    void flush() override {
+        flushed = true;
+    }
+
+    [[nodiscard]] std::vector<std::uint8_t> bytes() const {
+        std::vector<std::uint8_t> bytes;
+        for (const auto &block : blocks) {
+            bytes.insert(bytes.end(), block.begin(), block.end());
+        }
+        return bytes;
+    }
+};
+
+/// Sink which fails to write every block after the given number of blocks.
+class FailingSink : public io::ByteSink {
+private:
+    std::size_t m_written_blocks{0};
+    std::size_t m_max_blocks;
+
+public:
+    explicit FailingSink(const std::size_t max_blocks) : m_max_blocks(max_blocks) {}
+
+    void write_bytes(const tools::Span<const std::uint8_t>) override {
+        if (m_written_blocks == m_max_blocks) {
+            throw std::runtime_error("Sink is full.");
+        }
+        m_written_blocks++;
+    }
+};
+
+/// Stream an octree of version 1 into a sink in blocks of the given size.
+void stream_octree(const std::shared_ptr<const world::Cube> &cube, io::ByteSink &sink, const std::size_t block_size) {
+    io::ByteStreamWriter writer(sink, block_size);
+    io::serialize_octree_impl<1>(cube, writer, {});
+    writer.finish();
+}
+
+} // namespace
+
+TEST(OctreeParser, DeserializedOctreeHasTheSamePolygons) {
+    const auto cube = generate_octree(5);
+    const auto expected = collect_polygons(*cube);
+    for (std::uint32_t version = 0; version <= 3; version++) {
+        const auto octree = io::deserialize_octree(io::serialize_octree(cube, version));
+        EXPECT_EQ(collect_polygons(*octree), expected) << "version " << version;
+    }
+}
+
+TEST(OctreeParser, LoadedSubtreesInvalidateTheirNeighbours) {
+    // The solid childs of the root are above the index level, the childs of the octant are subtrees.
+    auto cube = std::make_shared<world::Cube>();
+    cube->set_type(world::Cube::Type::OCTANT);
+    (*cube)[4]->set_type(world::Cube::Type::OCTANT);
+    io::OctreeFormatSettings settings;
+    settings.index_level = 2;
+    const auto stream = io::serialize_octree(cube, 1, settings);
+
+    for (const bool parallel : {false, true}) {
+        io::OctreeIndex index(stream, std::make_shared<world::Cube>());
+        // The caches next to the empty subtrees contain the faces which the subtrees hide once they are loaded.
+        static_cast<void>(collect_polygons(*index.root()));
+        if (parallel) {
+            tools::ThreadPool thread_pool(2);
+            index.load_all(thread_pool);
+        } else {
+            index.load_all();
+        }
+        EXPECT_EQ(collect_polygons(*index.root()), collect_polygons(*cube)) << "parallel " << parallel;
+    }
+}
+
+TEST(OctreeParser, ParallelDeserializationMatchesTheSerialOne) {
+    const auto cube = generate_octree(5);
+    tools::ThreadPool thread_pool(4);
+    for (std::uint32_t version = 0; version <= 1; version++) {
+        for (const std::uint32_t index_level : {0U, 1U, 2U, 3U, 8U}) {
+            io::OctreeFormatSettings settings;
+            settings.index_level = index_level;
+            const auto stream = io::serialize_octree(cube, version, settings);
+            const auto expected = octree_bytes(io::deserialize_octree(stream));
+
+            io::OctreeIndex index(stream, std::make_shared<world::Cube>(), index_level);
+            index.load_all(thread_pool);
+            EXPECT_EQ(octree_bytes(index.root()), expected)
+                << "version " << version << ", index level " << index_level;
+            EXPECT_EQ(collect_polygons(*index.root()), collect_polygons(*cube))
+                << "version " << version << ", index level " << index_level;
+            EXPECT_EQ(octree_bytes(io::deserialize_octree(stream, thread_pool)), expected)
+                << "version " << version << ", index level " << index_level;
+        }
+    }
+}
+
+TEST(OctreeParser, ParallelDeserializationOfCorruptedSubtreeThrows) {
+    const auto stream = io::serialize_octree(generate_octree(4), 1);
+    std::vector<std::uint8_t> bytes(stream.data().begin(), stream.data().end());
+    {
+        // Change the type of the first cube of the last subtree to an invalid one.
+        io::OctreeIndex index(stream, std::make_shared<world::Cube>());
+        bytes[bytes.size() - index.subtree_size(index.subtree_count() - 1)] = 0xFF;
+    }
+    tools::ThreadPool thread_pool(4);
+    EXPECT_THROW(static_cast<void>(io::deserialize_octree(io::ByteStream(bytes), thread_pool)), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(io::deserialize_octree(io::ByteStream(bytes))), std::runtime_error);
+}
+
+TEST(OctreeParser, FlatDeserializationMatchesTheCubes) {
+    const auto cube = generate_octree(5);
+    const auto expected = octree_bytes(cube);
+    const auto check = [&](const io::ByteStream &stream, const std::uint32_t version) {
+        const world::FlatOctree octree = io::deserialize_flat_octree(stream);
+        EXPECT_EQ(octree_bytes(octree.to_cube()), expected) << "version " << version;
+    };
+    for (std::uint32_t version = 0; version <= 3; version++) {
+        check(io::serialize_octree(cube, version), version);
+    }
+    for (const std::uint32_t index_level : {0U, 1U, 3U, 8U}) {
+        check(io::serialize_octree(cube, 1, {index_level}), 1);
+    }
+}
+
+TEST(OctreeParser, FlatDeserializationOfCorruptedStreamThrows) {
+    for (std::uint32_t version = 0; version <= 3; version++) {
+        const auto stream = io::serialize_octree(generate_octree(4), version);
+        std::vector<std::uint8_t> bytes(stream.data().begin(), stream.data().end());
+        bytes.pop_back();
+        EXPECT_THROW(static_cast<void>(io::deserialize_flat_octree(io::ByteStream(bytes))), std::runtime_error)
+            << "version " << version;
+    }
+}
+
+TEST(OctreeParser, DeduplicatedOctreeIsLimitedByItsMemory) {
+    // Every octree has one cube more than a multiple of eight.
+    const std::uint64_t max_cubes = io::MAX_EXPANDED_OCTREE_MEMORY / sizeof(world::Cube);
+    const std::uint64_t largest = (max_cubes - 1) / world::Cube::SUB_CUBES * world::Cube::SUB_CUBES + 1;
+    const auto leaf_count = [](const std::uint64_t cube_count) {
+        return (cube_count - 1) / world::Cube::SUB_CUBES * (world::Cube::SUB_CUBES - 1) + 1;
+    };
+
+    const auto small = deduplicated_octree(1001);
+    EXPECT_EQ(world::FlatOctree(*io::deserialize_octree(small)).node_count(), 1001);
+    EXPECT_EQ(io::deserialize_flat_octree(small).node_count(), 1001);
+
+    const auto below = deduplicated_octree(largest);
+    EXPECT_LT(below.size(), 1024);
+    EXPECT_EQ(io::deserialize_flat_octree(below).node_count(), largest);
+    EXPECT_EQ(io::deserialize_octree_snapshot(below).count_geometry_cubes(), leaf_count(largest));
+
+    const auto above = deduplicated_octree(largest + world::Cube::SUB_CUBES);
+    EXPECT_THROW(static_cast<void>(io::deserialize_octree(above)), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(io::deserialize_octree_snapshot(above)), std::runtime_error);
+    EXPECT_THROW(static_cast<void>(io::deserialize_flat_octree(above)), std::runtime_error);
+}
+
+TEST(OctreeParser, StreamedSerializationMatchesTheBufferedOne) {
+    const auto cube = generate_octree(4);
+    for (std::uint32_t version = 0; version <= 3; version++) {
+        const auto buffered = io::serialize_octree(cube, version);
+        MemorySink sink;
+        io::serialize_octree(cube, sink, version);
+        EXPECT_TRUE(sink.flushed);
+        EXPECT_EQ(sink.bytes(), std::vector<std::uint8_t>(buffered.data().begin(), buffered.data().end()))
+            << "version " << version;
+    }
+}
+
+TEST(OctreeParser, StreamedSerializationInSmallBlocks) {
+    const auto cube = generate_octree(4);
+    const auto buffered = io::serialize_octree(cube, 1);
+    const std::vector<std::uint8_t> expected(buffered.data().begin(), buffered.data().end());
+    for (const std::size_t block_size : {1, 7, 1000}) {
+        MemorySink sink;
+        stream_octree(cube, sink, block_size);
+        EXPECT_EQ(sink.bytes(), expected) << "block size " << block_size;
+        // Every block but the last one is full, the last one holds the rest.
+        ASSERT_FALSE(sink.blocks.empty());
+        for (std::size_t idx = 0; idx + 1 < sink.blocks.size(); idx++) {
+            EXPECT_GE(sink.blocks[idx].size(), block_size);
+        }
+        EXPECT_FALSE(sink.blocks.back().empty());
+    }
+    ASSERT_NE(expected.size() % 7, 0);
+    ASSERT_NE(expected.size() % 1000, 0);
+}
+
+TEST(OctreeParser, FailingSinkThrowsFromStreamedSerialization) {
+    const auto cube = generate_octree(4);
+    // The whole octree fits into the last block, so it's written by finish.
+    FailingSink single_block(0);
+    EXPECT_THROW(stream_octree(cube, single_block, io::ByteStreamWriter::DEFAULT_BLOCK_SIZE), std::runtime_error);
+    FailingSink default_blocks(0);
+    EXPECT_THROW(io::serialize_octree(cube, default_blocks), std::runtime_error);
+    // A block which fails in the background is reported by the next block or by finish.
+    FailingSink later_block(3);
+    EXPECT_THROW(stream_octree(cube, later_block, 7), std::runtime_error);
+
+    FailingSink last_block(0);
+    io::ByteStreamWriter writer(last_block, 1024);
+    writer.write<std::uint32_t>(1);
+    EXPECT_THROW(writer.finish(), std::runtime_error);
+}
+
+} // namespace inexor::vulkan_renderer::tests
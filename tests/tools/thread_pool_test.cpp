@@ -0,0 +1,52 @@
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tools {
+
+TEST(ThreadPool, ParallelForCallsEveryIndexOnce) {
+    ThreadPool thread_pool(4);
+    std::vector<std::atomic<int>> calls(1000);
+    thread_pool.parallel_for(calls.size(), [&](const std::size_t index) { calls[index]++; });
+    for (const auto &count : calls) {
+        EXPECT_EQ(count.load(), 1);
+    }
+}
+
+TEST(ThreadPool, ParallelForRethrowsAfterAllCalls) {
+    ThreadPool thread_pool(4);
+    std::atomic<std::size_t> finished_calls{0};
+    EXPECT_THROW(thread_pool.parallel_for(100,
+                                          [&](const std::size_t index) {
+                                              if (index % 10 == 3) {
+                                                  throw std::runtime_error("Failed call.");
+                                              }
+                                              finished_calls++;
+                                          }),
+                 std::runtime_error);
+    EXPECT_EQ(finished_calls.load(), 90);
+
+    // The pool is still usable after a failed call.
+    std::atomic<std::size_t> calls{0};
+    thread_pool.parallel_for(100, [&](const std::size_t) { calls++; });
+    EXPECT_EQ(calls.load(), 100);
+}
+
+TEST(ThreadPool, NestedParallelForRethrows) {
+    ThreadPool thread_pool(2);
+    EXPECT_THROW(thread_pool.parallel_for(8,
+                                          [&](const std::size_t) {
+                                              thread_pool.parallel_for(8, [](const std::size_t index) {
+                                                  if (index == 5) {
+                                                      throw std::runtime_error("Failed nested call.");
+                                                  }
+                                              });
+                                          }),
+                 std::runtime_error);
+}
+
+} // namespace inexor::vulkan_renderer::tools
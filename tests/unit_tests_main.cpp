@@ -4,6 +4,7 @@
 
 int main(int argc, char **argv) {
     testing::InitGoogleTest(&argc, argv);
-    RUN_ALL_TESTS();
+    const int result = RUN_ALL_TESTS();
     std::cin.get();
+    return result;
 }
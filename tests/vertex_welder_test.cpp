@@ -0,0 +1,86 @@
+#include "world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/octree_gpu_vertex.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/vertex_welder.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace inexor::vulkan_renderer {
+
+namespace {
+
+/// The vertices of the polygons of a generated octree with a single color, so shared corners are identical. The
+/// octree is repeated side by side until there are enough vertices, every copy adds its own unique vertices.
+std::vector<OctreeGpuVertex> generate_vertices(const std::size_t count) {
+    std::vector<glm::vec3> positions;
+    for (const auto &polygon : tests::collect_polygons(*tests::generate_octree(6))) {
+        positions.insert(positions.end(), polygon.begin(), polygon.end());
+    }
+    std::vector<OctreeGpuVertex> vertices;
+    vertices.reserve(count);
+    for (std::size_t copy = 0; vertices.size() < count; copy++) {
+        const glm::vec3 offset{static_cast<float>(copy) * 2048.0F, 0.0F, 0.0F};
+        for (std::size_t idx = 0; idx < positions.size() && vertices.size() < count; idx++) {
+            vertices.emplace_back(positions[idx] + offset, glm::vec3{1.0F, 1.0F, 1.0F});
+        }
+    }
+    return vertices;
+}
+
+} // namespace
+
+TEST(VertexWelder, MergesLikeUnorderedMap) {
+    const auto input = generate_vertices(100'000);
+    std::vector<OctreeGpuVertex> expected_vertices;
+    std::vector<std::uint32_t> expected_indices;
+    std::unordered_map<OctreeGpuVertex, std::uint32_t> vertex_map;
+    for (const auto &vertex : input) {
+        const auto [iter, inserted] = vertex_map.emplace(vertex, static_cast<std::uint32_t>(vertex_map.size()));
+        if (inserted) {
+            expected_vertices.push_back(vertex);
+        }
+        expected_indices.push_back(iter->second);
+    }
+
+    VertexWelder welder;
+    std::vector<OctreeGpuVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    welder.weld(input, vertices, indices);
+    EXPECT_EQ(vertices, expected_vertices);
+    EXPECT_EQ(indices, expected_indices);
+}
+
+TEST(VertexWelder, ParallelWeldMatchesSerialWeld) {
+    const auto input = generate_vertices(10'000'000);
+    VertexWelder welder;
+    std::vector<OctreeGpuVertex> expected_vertices;
+    std::vector<std::uint32_t> expected_indices;
+    welder.weld(input, expected_vertices, expected_indices);
+    ASSERT_GT(expected_vertices.size(), std::numeric_limits<std::uint16_t>::max());
+
+    tools::ThreadPool thread_pool(4);
+    std::vector<OctreeGpuVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    welder.weld(input, vertices, indices, thread_pool);
+    EXPECT_EQ(vertices, expected_vertices);
+    EXPECT_EQ(indices, expected_indices);
+}
+
+TEST(VertexWelder, ThrowsIfIndexTypeOverflows) {
+    const auto input = generate_vertices(1'000'000);
+    VertexWelder welder;
+    std::vector<OctreeGpuVertex> vertices;
+    std::vector<std::uint16_t> indices;
+    EXPECT_THROW(welder.weld(input, vertices, indices), std::runtime_error);
+    tools::ThreadPool thread_pool(4);
+    EXPECT_THROW(welder.weld(input, vertices, indices, thread_pool), std::runtime_error);
+}
+
+} // namespace inexor::vulkan_renderer
@@ -0,0 +1,208 @@
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
+#include "inexor/vulkan-renderer/tools/thread_pool.hpp"
+#include "inexor/vulkan-renderer/world/chunk_streamer.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// World whose chunks are kept in memory, it counts how often every chunk has been read.
+struct InMemoryWorld {
+    std::unordered_map<ChunkCoordinate, io::ByteStream, ChunkCoordinateHash> streams;
+    /// Reading these chunks throws.
+    std::vector<ChunkCoordinate> unreadable;
+    std::mutex mutex;
+    std::unordered_map<ChunkCoordinate, std::size_t, ChunkCoordinateHash> reads;
+
+    [[nodiscard]] std::size_t read_count(const ChunkCoordinate &coordinate) {
+        std::lock_guard lock(mutex);
+        const auto iter = reads.find(coordinate);
+        return iter == reads.end() ? 0 : iter->second;
+    }
+};
+
+/// Load the chunks from an in-memory world, chunks without a stream are empty space.
+ChunkStreamer::ChunkLoader in_memory_loader(const std::shared_ptr<InMemoryWorld> &world) {
+    return [world](const ChunkCoordinate &coordinate) -> std::optional<io::ByteStream> {
+        std::lock_guard lock(world->mutex);
+        world->reads[coordinate]++;
+        if (std::find(world->unreadable.begin(), world->unreadable.end(), coordinate) != world->unreadable.end()) {
+            throw std::runtime_error("Unreadable chunk.");
+        }
+        const auto iter = world->streams.find(coordinate);
+        if (iter == world->streams.end()) {
+            return std::nullopt;
+        }
+        return iter->second;
+    };
+}
+
+/// Serialized octree of a chunk which is a single Type::SOLID cube.
+io::ByteStream solid_chunk() {
+    return io::serialize_octree(std::make_shared<const Cube>(Cube::Type::SOLID), 0);
+}
+
+/// Chunks of size 32, the chunk of the camera and its six face neighbours are within the load radius.
+ChunkStreamer::Settings settings() {
+    ChunkStreamer::Settings settings;
+    settings.chunk_size = 32.0F;
+    settings.load_radius = 40.0F;
+    return settings;
+}
+
+/// Camera in the center of the chunk.
+glm::vec3 center_of(const ChunkCoordinate &coordinate) {
+    return (glm::vec3(coordinate) + 0.5F) * 32.0F;
+}
+
+/// Update the streamer until all requested chunks have been loaded and no new chunk is requested.
+void update_until_idle(ChunkStreamer &streamer, const glm::vec3 &camera_position) {
+    const auto timeout = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    static_cast<void>(streamer.update(camera_position));
+    while (streamer.metrics().pending_loads > 0) {
+        ASSERT_LT(std::chrono::steady_clock::now(), timeout) << "Chunks are not loaded.";
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        static_cast<void>(streamer.update(camera_position));
+    }
+}
+
+/// The six face neighbours of a chunk.
+std::vector<ChunkCoordinate> face_neighbours(const ChunkCoordinate &coordinate) {
+    return {coordinate + ChunkCoordinate{-1, 0, 0}, coordinate + ChunkCoordinate{1, 0, 0},
+            coordinate + ChunkCoordinate{0, -1, 0}, coordinate + ChunkCoordinate{0, 1, 0},
+            coordinate + ChunkCoordinate{0, 0, -1}, coordinate + ChunkCoordinate{0, 0, 1}};
+}
+
+} // namespace
+
+TEST(ChunkStreamer, LoadsTheChunksAroundTheCamera) {
+    const auto world = std::make_shared<InMemoryWorld>();
+    world->streams.emplace(ChunkCoordinate{0, 0, 0}, solid_chunk());
+    world->streams.emplace(ChunkCoordinate{1, 0, 0}, solid_chunk());
+    tools::ThreadPool thread_pool(2);
+    ChunkStreamer streamer(thread_pool, in_memory_loader(world), settings());
+
+    update_until_idle(streamer, center_of({0, 0, 0}));
+    const auto &chunks = streamer.chunks();
+    ASSERT_EQ(chunks.size(), 7);
+    ASSERT_NE(chunks.at({0, 0, 0}).root, nullptr);
+    ASSERT_NE(chunks.at({1, 0, 0}).root, nullptr);
+    EXPECT_EQ(chunks.at({1, 0, 0}).root->position(), glm::vec3(32.0F, 0.0F, 0.0F));
+    EXPECT_EQ(chunks.at({1, 0, 0}).root->size(), 32.0F);
+    for (const auto &neighbour : face_neighbours({0, 0, 0})) {
+        EXPECT_EQ(world->read_count(neighbour), 1);
+        if (neighbour != ChunkCoordinate{1, 0, 0}) {
+            EXPECT_EQ(chunks.at(neighbour).root, nullptr);
+        }
+    }
+    EXPECT_EQ(streamer.metrics().loaded_chunks, 7);
+    EXPECT_EQ(streamer.metrics().failed_loads, 0);
+    EXPECT_EQ(streamer.metrics().cpu_memory, 2 * sizeof(Cube));
+    EXPECT_EQ(streamer.metrics().gpu_memory, 2 * 12 * 3 * streamer.settings().vertex_size);
+}
+
+TEST(ChunkStreamer, FailedAndEmptyChunksAreDroppedOutsideOfTheLoadRadius) {
+    const auto world = std::make_shared<InMemoryWorld>();
+    world->streams.emplace(ChunkCoordinate{0, 0, 0}, solid_chunk());
+    world->streams.emplace(ChunkCoordinate{0, 1, 0}, io::ByteStream(std::vector<std::uint8_t>{1, 2, 3}));
+    world->unreadable.push_back({0, 0, 1});
+    tools::ThreadPool thread_pool(2);
+    ChunkStreamer streamer(thread_pool, in_memory_loader(world), settings());
+
+    update_until_idle(streamer, center_of({0, 0, 0}));
+    EXPECT_EQ(streamer.metrics().failed_loads, 2);
+    EXPECT_EQ(streamer.chunks().at({0, 1, 0}).root, nullptr);
+    EXPECT_EQ(streamer.chunks().at({0, 0, 1}).root, nullptr);
+    // Failed chunks are not requested again while they are resident.
+    for (int frame = 0; frame < 3; frame++) {
+        update_until_idle(streamer, center_of({0, 0, 0}));
+    }
+    EXPECT_EQ(world->read_count({0, 1, 0}), 1);
+    EXPECT_EQ(world->read_count({0, 0, 1}), 1);
+
+    // Far away the empty and failed chunks are dropped, the chunk with geometry stays as the budgets are met.
+    update_until_idle(streamer, center_of({10, 0, 0}));
+    EXPECT_EQ(streamer.chunks().count({0, 1, 0}), 0);
+    EXPECT_EQ(streamer.chunks().count({0, 0, 1}), 0);
+    EXPECT_EQ(streamer.chunks().count({1, 0, 0}), 0);
+    EXPECT_NE(streamer.chunks().at({0, 0, 0}).root, nullptr);
+    EXPECT_EQ(streamer.metrics().evicted_chunks, 0);
+
+    update_until_idle(streamer, center_of({0, 0, 0}));
+    EXPECT_EQ(world->read_count({0, 0, 0}), 1);
+    EXPECT_EQ(world->read_count({0, 0, 1}), 2);
+    EXPECT_EQ(streamer.metrics().failed_loads, 4);
+}
+
+TEST(ChunkStreamer, NoChunksAreRequestedWhileOverBudget) {
+    const auto world = std::make_shared<InMemoryWorld>();
+    world->streams.emplace(ChunkCoordinate{0, 0, 0}, solid_chunk());
+    for (const auto &neighbour : face_neighbours({0, 0, 0})) {
+        world->streams.emplace(neighbour, solid_chunk());
+    }
+    auto budget_settings = settings();
+    budget_settings.cpu_memory_budget = 2 * sizeof(Cube);
+    budget_settings.max_pending_loads = 1;
+    tools::ThreadPool thread_pool(2);
+    ChunkStreamer streamer(thread_pool, in_memory_loader(world), budget_settings);
+
+    // The third chunk exceeds the budget, chunks within the load radius are never evicted.
+    for (int frame = 0; frame < 10; frame++) {
+        update_until_idle(streamer, center_of({0, 0, 0}));
+    }
+    EXPECT_EQ(streamer.chunks().size(), 3);
+    EXPECT_EQ(streamer.metrics().loaded_chunks, 3);
+    EXPECT_EQ(streamer.metrics().evicted_chunks, 0);
+    EXPECT_EQ(world->read_count({0, 0, 0}), 1);
+}
+
+TEST(ChunkStreamer, EvictsTheFurthestChunksFirst) {
+    const auto world = std::make_shared<InMemoryWorld>();
+    for (int x = -1; x <= 3; x++) {
+        for (int y = -1; y <= 1; y++) {
+            for (int z = -1; z <= 1; z++) {
+                world->streams.emplace(ChunkCoordinate{x, y, z}, solid_chunk());
+            }
+        }
+    }
+    auto budget_settings = settings();
+    budget_settings.cpu_memory_budget = 8 * sizeof(Cube);
+    tools::ThreadPool thread_pool(2);
+    ChunkStreamer streamer(thread_pool, in_memory_loader(world), budget_settings);
+    update_until_idle(streamer, center_of({0, 0, 0}));
+    ASSERT_EQ(streamer.chunks().size(), 7);
+
+    // Six new chunks exceed the budget by five chunks. The chunk at (-1, 0, 0) is the furthest one, followed by the
+    // four side neighbours of the old camera chunk. Its own chunk is the closest one outside of the load radius.
+    update_until_idle(streamer, center_of({2, 0, 0}));
+    update_until_idle(streamer, center_of({2, 0, 0}));
+    const auto &chunks = streamer.chunks();
+    EXPECT_EQ(streamer.metrics().evicted_chunks, 5);
+    EXPECT_EQ(streamer.metrics().cpu_memory, 8 * sizeof(Cube));
+    EXPECT_EQ(chunks.size(), 8);
+    EXPECT_EQ(chunks.count({0, 0, 0}), 1);
+    EXPECT_EQ(chunks.count({1, 0, 0}), 1);
+    for (const auto &neighbour : face_neighbours({0, 0, 0})) {
+        EXPECT_EQ(chunks.count(neighbour), (neighbour == ChunkCoordinate{1, 0, 0} ? 1 : 0));
+    }
+    for (const auto &neighbour : face_neighbours({2, 0, 0})) {
+        EXPECT_EQ(chunks.count(neighbour), 1);
+    }
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,238 @@
+#include "../world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// Number of cubes in an octree, octants included.
+std::size_t count_cubes(const Cube &root) {
+    std::size_t count = 0;
+    visit_pre_order(root, [&count](const Cube &) {
+        count++;
+        return true;
+    });
+    return count;
+}
+
+/// Visible surface area of an octree.
+float surface_area(const Cube &root) {
+    float sum = 0.0F;
+    for (const auto &polygon : tests::collect_polygons(root)) {
+        sum += glm::length(glm::cross(polygon[1] - polygon[0], polygon[2] - polygon[0])) / 2;
+    }
+    return sum;
+}
+
+/// An empty octree of size 32 with a Type::SOLID child next to the origin in positive x direction, and an octant
+/// of Type::SOLID childs in the far corner of the negative x half.
+std::shared_ptr<Cube> octree_for_queries() {
+    const auto cube = std::make_shared<Cube>(Cube::Type::EMPTY, 32.0F, glm::vec3{0.0F});
+    cube->set_type(Cube::Type::OCTANT);
+    for (const auto &child : cube->childs()) {
+        child->set_type(Cube::Type::EMPTY);
+    }
+    // about the order look into the octree documentation
+    cube->childs()[4]->set_type(Cube::Type::SOLID);
+    cube->childs()[3]->set_type(Cube::Type::OCTANT);
+    return cube;
+}
+
+} // namespace
+
+TEST(CubeTest, BatchedPolygonsMatchPolygonsPerCube) {
+    // The polygons of Type::NORMAL cubes are generated in batches.
+    const auto cube = tests::generate_octree(5);
+    const auto polygons = tests::collect_polygons(*cube);
+    std::vector<Polygon> expected;
+    visit_leaves(*cube, [&expected](const Cube &leaf) {
+        leaf.update_polygon_cache();
+        const auto cache = leaf.polygon_cache();
+        expected.insert(expected.end(), cache.begin(), cache.end());
+    });
+    EXPECT_EQ(polygons, expected);
+}
+
+TEST(CubeTest, CloneHasTheSamePolygons) {
+    const auto cube = tests::generate_octree(4);
+    const auto copy = cube->clone();
+    EXPECT_EQ(tests::collect_polygons(*copy), tests::collect_polygons(*cube));
+}
+
+TEST(CubeTest, CopyOfSubtreeIsOnTheFirstGridLevel) {
+    const auto cube = std::make_shared<Cube>(Cube::Type::EMPTY, 32.0F, glm::vec3{0.0F});
+    cube->set_type(Cube::Type::OCTANT);
+    cube->childs()[0]->set_type(Cube::Type::OCTANT);
+    const auto &subtree = cube->childs()[0]->childs()[0];
+    ASSERT_EQ(subtree->grid_level(), 2);
+    EXPECT_EQ(std::make_shared<Cube>(*subtree)->grid_level(), 0);
+    EXPECT_EQ(std::make_shared<Cube>(*cube->childs()[0])->childs()[0]->grid_level(), 0);
+    const auto clone = cube->childs()[0]->clone();
+    EXPECT_EQ(clone->grid_level(), 0);
+    EXPECT_EQ(clone->childs()[0]->grid_level(), 1);
+}
+
+TEST(CubeTest, CloneCullsFacesAcrossItsChilds) {
+    // The grandchilds need the root of the clone to find their neighbours in the other childs.
+    const auto cube = std::make_shared<Cube>(Cube::Type::EMPTY, 32.0F, glm::vec3{0.0F});
+    cube->set_type(Cube::Type::OCTANT);
+    for (const auto &child : cube->childs()) {
+        child->set_type(Cube::Type::OCTANT);
+    }
+    const auto copy = cube->clone();
+    EXPECT_EQ(tests::collect_polygons(*copy), tests::collect_polygons(*cube));
+}
+
+TEST(CubeTest, AssignedCopyHasTheSamePolygons) {
+    const auto cube = tests::generate_octree(4);
+    const auto other = std::make_shared<Cube>(Cube::Type::SOLID, 32.0F, glm::vec3{0.0F});
+    *other = Cube(*cube);
+    EXPECT_EQ(tests::collect_polygons(*other), tests::collect_polygons(*cube));
+}
+
+TEST(CubeTest, CompactCollapsesUniformOctantsAndKeepsTheSurface) {
+    for (const std::uint32_t seed : {1U, 2U, 3U}) {
+        const auto cube = tests::generate_octree(4, seed);
+        // Make the first half of the octree solid, so it collapses into four leaves.
+        for (std::size_t idx = 0; idx < Cube::SUB_CUBES / 2; idx++) {
+            visit_leaves(*cube->childs()[idx], [](Cube &leaf) { leaf.set_type(Cube::Type::SOLID); });
+        }
+        const auto original = cube->clone();
+        const std::size_t cube_count = count_cubes(*cube);
+
+        const std::size_t removed_cubes = cube->compact();
+        EXPECT_GE(removed_cubes, Cube::SUB_CUBES / 2);
+        EXPECT_EQ(count_cubes(*cube), cube_count - removed_cubes);
+        for (std::size_t idx = 0; idx < Cube::SUB_CUBES / 2; idx++) {
+            EXPECT_EQ(cube->childs()[idx]->type(), Cube::Type::SOLID);
+        }
+        visit_pre_order(*cube, [](const Cube &octant) {
+            if (octant.type() == Cube::Type::OCTANT) {
+                const auto type = octant.childs()[0]->type();
+                const bool uniform = std::all_of(octant.childs().begin(), octant.childs().end(),
+                                                 [type](const auto &child) { return child->type() == type; });
+                EXPECT_FALSE(uniform && (type == Cube::Type::EMPTY || type == Cube::Type::SOLID));
+            }
+            return true;
+        });
+
+        // The same space is filled, so the surface stays the same. Faces of the collapsed leaves which are partly hidden
+        // by smaller neighbours are drawn in full though, so the area can grow.
+        const float size = cube->size() / 16;
+        for (float x = size / 2; x < cube->size(); x += size) {
+            for (float y = size / 2; y < cube->size(); y += size) {
+                for (float z = size / 2; z < cube->size(); z += size) {
+                    const glm::vec3 point{x, y, z};
+                    EXPECT_EQ(cube->leaf_at(point)->type(), original->leaf_at(point)->type());
+                }
+            }
+        }
+        EXPECT_GE(surface_area(*cube), surface_area(*original));
+        // The caches of the compacted octree are up to date.
+        const auto rebuilt = cube->clone();
+        visit_pre_order(*rebuilt, [](const Cube &cube) {
+            cube.invalidate_polygon_cache();
+            return true;
+        });
+        EXPECT_EQ(tests::collect_polygons(*cube), tests::collect_polygons(*rebuilt));
+    }
+}
+
+TEST(CubeTest, AutoCompactCollapsesAllUniformAncestors) {
+    const auto cube = std::make_shared<Cube>(Cube::Type::EMPTY, 32.0F, glm::vec3{0.0F});
+    cube->set_type(Cube::Type::OCTANT);
+    cube->childs()[0]->set_type(Cube::Type::OCTANT);
+    const auto leaf = cube->childs()[0]->childs()[0];
+    leaf->set_type(Cube::Type::EMPTY);
+    cube->set_auto_compact(true);
+
+    // Filling the leaf makes its parent uniform, which then makes the root uniform.
+    leaf->set_type(Cube::Type::SOLID);
+    EXPECT_EQ(cube->type(), Cube::Type::SOLID);
+    EXPECT_EQ(cube->childs()[0], nullptr);
+    const Cube solid(Cube::Type::SOLID, 32.0F, glm::vec3{0.0F});
+    EXPECT_EQ(tests::collect_polygons(*cube), tests::collect_polygons(solid));
+}
+
+TEST(CubeTest, RaycastHitsTheFirstGeometryCube) {
+    const auto cube = octree_for_queries();
+    const auto hit = cube->raycast({-10.0F, 8.0F, 8.0F}, {2.0F, 0.0F, 0.0F});
+    ASSERT_TRUE(hit.has_value());
+    EXPECT_EQ(hit->cube, cube->childs()[4]);
+    EXPECT_FLOAT_EQ(hit->distance, 13.0F);
+    EXPECT_EQ(hit->axis, 0);
+    EXPECT_FALSE(hit->positive_direction);
+
+    const auto diagonal_hit = cube->raycast({-8.0F, 24.0F, 40.0F}, {1.0F, -0.5F, -1.0F});
+    ASSERT_TRUE(diagonal_hit.has_value());
+    EXPECT_EQ(diagonal_hit->cube, cube->childs()[3]->childs()[1]);
+    EXPECT_FLOAT_EQ(diagonal_hit->distance, 8.0F);
+    EXPECT_EQ(diagonal_hit->axis, 0);
+}
+
+TEST(CubeTest, RaycastMisses) {
+    const auto cube = octree_for_queries();
+    EXPECT_FALSE(cube->raycast({-10.0F, 24.0F, 8.0F}, {1.0F, 0.0F, 0.0F}).has_value());
+    EXPECT_FALSE(cube->raycast({-10.0F, 8.0F, 8.0F}, {-1.0F, 0.0F, 0.0F}).has_value());
+    EXPECT_FALSE(cube->raycast({-10.0F, 8.0F, 8.0F}, {1.0F, 0.0F, 0.0F}, 20.0F).has_value());
+    EXPECT_FALSE(cube->raycast({-10.0F, 40.0F, 8.0F}, {1.0F, 0.0F, 0.0F}).has_value());
+}
+
+TEST(CubeTest, RaycastParallelToTheFacesOfCubes) {
+    const auto cube = octree_for_queries();
+    // Rays along the border between two cubes touch both of them, no matter the sign of the zero components.
+    for (const float zero : {0.0F, -0.0F}) {
+        for (const glm::vec3 &origin : {glm::vec3{-10.0F, 16.0F, 8.0F}, glm::vec3{-10.0F, 0.0F, 16.0F}}) {
+            const auto hit = cube->raycast(origin, {1.0F, zero, zero});
+            ASSERT_TRUE(hit.has_value()) << "zero " << zero << " origin y " << origin.y;
+            EXPECT_EQ(hit->cube, cube->childs()[4]);
+            EXPECT_FLOAT_EQ(hit->distance, 26.0F);
+        }
+        const auto hit = cube->raycast({4.0F, -10.0F, 20.0F}, {zero, 1.0F, zero});
+        ASSERT_TRUE(hit.has_value());
+        EXPECT_EQ(hit->cube, cube->childs()[3]->childs()[0]);
+        EXPECT_EQ(hit->axis, 1);
+        EXPECT_FALSE(cube->raycast({8.0F, 40.0F, 8.0F}, {zero, zero, 1.0F}).has_value());
+    }
+}
+
+TEST(CubeTest, LeafAtPointOnBorders) {
+    const auto cube = octree_for_queries();
+    EXPECT_EQ(cube->leaf_at({20.0F, 4.0F, 4.0F}), cube->childs()[4]);
+    // Points on the border between two leaves belong to the one in positive axis direction.
+    EXPECT_EQ(cube->leaf_at({16.0F, 4.0F, 4.0F}), cube->childs()[4]);
+    EXPECT_EQ(cube->leaf_at({8.0F, 16.0F, 16.0F}), cube->childs()[3]->childs()[4]);
+    EXPECT_EQ(cube->leaf_at({32.0F, 32.0F, 32.0F}), cube->childs()[7]);
+    EXPECT_EQ(cube->leaf_at({0.0F, 0.0F, 0.0F}), cube->childs()[0]);
+    EXPECT_EQ(cube->leaf_at({-1.0F, 4.0F, 4.0F}), nullptr);
+    EXPECT_EQ(cube->leaf_at({4.0F, 4.0F, 32.5F}), nullptr);
+}
+
+TEST(CubeTest, LeavesInBoxOnBorders) {
+    const auto cube = octree_for_queries();
+    // Leaves which only touch the border of the box are left out.
+    EXPECT_EQ(cube->leaves_in_box({16.0F, 0.0F, 0.0F}, {32.0F, 16.0F, 16.0F}),
+              std::vector<std::shared_ptr<Cube>>{cube->childs()[4]});
+    EXPECT_EQ(cube->leaves_in_box({0.0F, 16.0F, 16.0F}, {8.0F, 24.0F, 24.0F}),
+              std::vector<std::shared_ptr<Cube>>{cube->childs()[3]->childs()[0]});
+    EXPECT_EQ(cube->leaves_in_box({15.0F, 0.0F, 0.0F}, {17.0F, 1.0F, 1.0F}),
+              (std::vector<std::shared_ptr<Cube>>{cube->childs()[0], cube->childs()[4]}));
+    EXPECT_EQ(cube->leaves_in_box({7.0F, 15.0F, 15.0F}, {9.0F, 16.5F, 16.5F}),
+              (std::vector<std::shared_ptr<Cube>>{cube->childs()[0], cube->childs()[1], cube->childs()[2],
+                                                  cube->childs()[3]->childs()[0], cube->childs()[3]->childs()[4]}));
+    EXPECT_TRUE(cube->leaves_in_box({32.0F, 0.0F, 0.0F}, {40.0F, 8.0F, 8.0F}).empty());
+    EXPECT_EQ(cube->leaves_in_box({-8.0F, -8.0F, -8.0F}, {40.0F, 40.0F, 40.0F}).size(), 15);
+}
+
+} // namespace inexor::vulkan_renderer::world
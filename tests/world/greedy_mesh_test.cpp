@@ -0,0 +1,128 @@
+#include "../world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/greedy_mesh.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <glm/geometric.hpp>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// Plane of a face: axis of the normal, direction of the normal and the position on the axis.
+using Plane = std::tuple<std::size_t, bool, float>;
+
+/// Group the polygons by their plane.
+std::map<Plane, std::vector<Polygon>> polygons_by_plane(const std::vector<Polygon> &polygons) {
+    std::map<Plane, std::vector<Polygon>> planes;
+    for (const auto &polygon : polygons) {
+        const glm::vec3 normal = glm::cross(polygon[1] - polygon[0], polygon[2] - polygon[0]);
+        std::size_t axis = 0;
+        for (std::size_t idx = 1; idx < 3; idx++) {
+            axis = std::abs(normal[idx]) > std::abs(normal[axis]) ? idx : axis;
+        }
+        planes[{axis, normal[axis] > 0.0F, polygon[0][axis]}].push_back(polygon);
+    }
+    return planes;
+}
+
+/// Area of the polygons of a plane.
+float area(const std::vector<Polygon> &polygons) {
+    float sum = 0.0F;
+    for (const auto &polygon : polygons) {
+        // The polygons are axis aligned, so their normal has a single component.
+        const glm::vec3 normal = glm::cross(polygon[1] - polygon[0], polygon[2] - polygon[0]);
+        sum += (std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z)) / 2;
+    }
+    return sum;
+}
+
+/// Is the point inside of one of the polygons of a plane, borders included.
+bool is_covered(const glm::vec3 &point, const std::size_t axis, const std::vector<Polygon> &polygons) {
+    const std::size_t u_axis = (axis + 1) % 3;
+    const std::size_t v_axis = (axis + 2) % 3;
+    const auto side = [&](const glm::vec3 &a, const glm::vec3 &b) {
+        return (b[u_axis] - a[u_axis]) * (point[v_axis] - a[v_axis]) -
+               (b[v_axis] - a[v_axis]) * (point[u_axis] - a[u_axis]);
+    };
+    for (const auto &polygon : polygons) {
+        const float first = side(polygon[0], polygon[1]);
+        const float second = side(polygon[1], polygon[2]);
+        const float third = side(polygon[2], polygon[0]);
+        if ((first >= 0 && second >= 0 && third >= 0) || (first <= 0 && second <= 0 && third <= 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Check that both meshes cover the same faces: every plane has the same area, and the center of every polygon of one
+/// mesh is covered by the other mesh.
+void expect_same_faces(const std::vector<Polygon> &greedy, const std::vector<Polygon> &expected) {
+    const auto greedy_planes = polygons_by_plane(greedy);
+    const auto expected_planes = polygons_by_plane(expected);
+    ASSERT_EQ(greedy_planes.size(), expected_planes.size());
+    for (const auto &[plane, polygons] : expected_planes) {
+        const auto iter = greedy_planes.find(plane);
+        ASSERT_NE(iter, greedy_planes.end());
+        EXPECT_FLOAT_EQ(area(iter->second), area(polygons));
+        const std::size_t axis = std::get<0>(plane);
+        for (const auto &polygon : polygons) {
+            EXPECT_TRUE(is_covered((polygon[0] + polygon[1] + polygon[2]) / 3.0F, axis, iter->second));
+        }
+        for (const auto &polygon : iter->second) {
+            EXPECT_TRUE(is_covered((polygon[0] + polygon[1] + polygon[2]) / 3.0F, axis, polygons));
+        }
+    }
+}
+
+} // namespace
+
+TEST(GreedyMesh, MergesFacesOfCubesOfDifferentSizes) {
+    // An octant of eight solid cubes next to a solid cube of twice their size, their faces share the same planes.
+    const auto root = std::make_shared<Cube>(Cube::Type::EMPTY, 32.0F, glm::vec3{0.0F});
+    root->set_type(Cube::Type::OCTANT);
+    for (const auto &child : root->childs()) {
+        child->set_type(Cube::Type::EMPTY);
+    }
+    root->childs()[0]->set_type(Cube::Type::OCTANT);
+    root->childs()[4]->set_type(Cube::Type::SOLID);
+    root->childs()[1]->set_type(Cube::Type::OCTANT);
+    for (std::size_t idx = 1; idx < Cube::SUB_CUBES; idx++) {
+        root->childs()[1]->childs()[idx]->set_type(Cube::Type::EMPTY);
+    }
+
+    const auto expected = tests::collect_polygons(*root);
+    const auto greedy = greedy_mesh(*root);
+    expect_same_faces(greedy, expected);
+    EXPECT_LT(greedy.size(), expected.size());
+}
+
+TEST(GreedyMesh, CoversTheFacesOfSolidOctrees) {
+    for (const std::uint32_t seed : {1U, 2U, 3U}) {
+        const auto root = tests::generate_octree(4, seed);
+        std::vector<Cube *> normal_cubes;
+        visit_leaves(*root, [&normal_cubes](Cube &cube) {
+            if (cube.type() == Cube::Type::NORMAL) {
+                normal_cubes.push_back(&cube);
+            }
+        });
+        for (Cube *cube : normal_cubes) {
+            cube->set_type(Cube::Type::SOLID);
+        }
+        const auto expected = tests::collect_polygons(*root);
+        const auto greedy = greedy_mesh(*root);
+        expect_same_faces(greedy, expected);
+        EXPECT_LT(greedy.size(), expected.size()) << "seed " << seed;
+    }
+}
+
+} // namespace inexor::vulkan_renderer::world
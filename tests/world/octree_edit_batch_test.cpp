@@ -0,0 +1,114 @@
+#include "../world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/io/byte_stream.hpp"
+#include "inexor/vulkan-renderer/io/octree_parser.hpp"
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+#include "inexor/vulkan-renderer/world/octree_edit_batch.hpp"
+#include "inexor/vulkan-renderer/world/octree_mesh.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// An octree of the default root size, whose childs are all Type::SOLID leaves.
+std::shared_ptr<Cube> solid_octant() {
+    const auto root = std::make_shared<Cube>();
+    root->set_type(Cube::Type::OCTANT);
+    return root;
+}
+
+/// The polygons of an octree, which is built from scratch with the same cubes.
+std::vector<Polygon> rebuilt_polygons(const std::shared_ptr<Cube> &root) {
+    return tests::collect_polygons(*io::deserialize_octree(io::serialize_octree(root, 0)));
+}
+
+} // namespace
+
+TEST(OctreeEditBatch, MergesEditsOfTheSameCube) {
+    const auto root = solid_octant();
+    const auto &cube = root->childs()[0];
+    OctreeEditBatch batch;
+    batch.set_type(cube, Cube::Type::NORMAL);
+    batch.indent(cube, 0, true, 2);
+    batch.set_indent(cube, 1, Indentation(3, 5));
+    // Setting the current type doesn't change the cube, so it is left out of the changed cubes.
+    batch.set_type(root->childs()[1], Cube::Type::SOLID);
+    EXPECT_EQ(batch.size(), 2);
+
+    const auto changed = batch.commit();
+    EXPECT_TRUE(batch.empty());
+    ASSERT_EQ(changed.size(), 1);
+    EXPECT_EQ(changed[0], cube);
+
+    // The edits end up like the same edits on a single cube.
+    Cube expected(Cube::Type::SOLID, cube->size(), cube->position());
+    expected.set_type(Cube::Type::NORMAL);
+    expected.indent(0, true, 2);
+    expected.set_indent(1, Indentation(3, 5));
+    EXPECT_EQ(cube->type(), Cube::Type::NORMAL);
+    EXPECT_EQ(cube->indentations(), expected.indentations());
+}
+
+TEST(OctreeEditBatch, DropsCubesWhoseAncestorIsReplaced) {
+    const auto root = solid_octant();
+    const auto &octant = root->childs()[0];
+    octant->set_type(Cube::Type::OCTANT);
+    const auto grandchild = octant->childs()[3];
+
+    OctreeEditBatch batch;
+    batch.set_type(grandchild, Cube::Type::EMPTY);
+    batch.set_type(octant, Cube::Type::EMPTY);
+    const auto changed = batch.commit();
+
+    ASSERT_EQ(changed.size(), 1);
+    EXPECT_EQ(changed[0], octant);
+    EXPECT_EQ(octant->type(), Cube::Type::EMPTY);
+    EXPECT_EQ(tests::collect_polygons(*root), rebuilt_polygons(root));
+}
+
+TEST(OctreeEditBatch, MarksTheNeighboursDirty) {
+    const auto root = solid_octant();
+    // Update the mesh once, so all cubes are clean.
+    OctreeMesh mesh;
+    static_cast<void>(mesh.update(*root));
+
+    OctreeEditBatch batch;
+    batch.set_type(root->childs()[0], Cube::Type::EMPTY);
+    static_cast<void>(batch.commit());
+
+    // about the order look into the octree documentation
+    for (std::size_t idx = 1; idx < Cube::SUB_CUBES; idx++) {
+        // Only the childs sharing a face with the emptied child reveal a face.
+        const bool shares_face = idx == 1 || idx == 2 || idx == 4;
+        EXPECT_EQ(root->childs()[idx]->is_dirty(), shares_face) << "child " << idx;
+    }
+    EXPECT_EQ(tests::collect_polygons(*root), rebuilt_polygons(root));
+}
+
+TEST(OctreeEditBatch, AutoCompactCollapsesUniformOctants) {
+    const auto root = solid_octant();
+    const auto &octant = root->childs()[0];
+    octant->set_type(Cube::Type::OCTANT);
+    octant->childs()[0]->set_type(Cube::Type::EMPTY);
+    root->set_auto_compact(true);
+
+    OctreeEditBatch batch;
+    for (std::size_t idx = 1; idx < Cube::SUB_CUBES; idx++) {
+        batch.set_type(octant->childs()[idx], Cube::Type::EMPTY);
+    }
+    const auto changed = batch.commit();
+
+    // The emptied childs are removed by the collapse of their parent, the other childs of the root stay solid.
+    EXPECT_TRUE(changed.empty());
+    EXPECT_EQ(octant->type(), Cube::Type::EMPTY);
+    EXPECT_EQ(root->type(), Cube::Type::OCTANT);
+    EXPECT_EQ(tests::collect_polygons(*root), rebuilt_polygons(root));
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/indentation.hpp"
+
+#include <glm/vec3.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace inexor::vulkan_renderer::tests {
+
+/// Generate a reproducible random octree with the default size and position of a root cube, so it matches the octrees
+/// returned by io::deserialize_octree.
+/// @param depth The grid level of the smallest cubes.
+/// @param subdivide_chance Chance of an octant to be subdivided further.
+[[nodiscard]] inline std::shared_ptr<world::Cube> generate_octree(const std::size_t depth,
+                                                                  const std::uint32_t seed = 42,
+                                                                  const float subdivide_chance = 0.7F) {
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<float> chance(0.0F, 1.0F);
+    std::uniform_int_distribution<int> leaf_type(0, 2);
+    std::uniform_int_distribution<int> indentation_uid(0, 44);
+
+    auto root = std::make_shared<world::Cube>();
+    auto generate = [&](auto &self, world::Cube &cube, const std::size_t level) -> void {
+        if (level < depth && (level == 0 || chance(generator) < subdivide_chance)) {
+            cube.set_type(world::Cube::Type::OCTANT);
+            for (const auto &child : cube.childs()) {
+                self(self, *child, level + 1);
+            }
+            return;
+        }
+        cube.set_type(static_cast<world::Cube::Type>(leaf_type(generator)));
+        if (cube.type() == world::Cube::Type::NORMAL) {
+            for (std::uint8_t edge_id = 0; edge_id < world::Cube::EDGES; edge_id++) {
+                cube.set_indent(edge_id, world::Indentation(static_cast<std::uint8_t>(indentation_uid(generator))));
+            }
+        }
+    };
+    generate(generate, *root, 0);
+    return root;
+}
+
+/// Generate an octree which looks like architecture: a solid floor with a grid of solid walls on top of it.
+/// Large areas are merged into bigger cubes, only the borders between floor, walls and air are subdivided. The root has a
+/// size of 1024.
+/// @param depth The grid level of the smallest cubes, which is also the thickness of the walls.
+[[nodiscard]] inline std::shared_ptr<world::Cube> generate_architecture(const std::size_t depth) {
+    constexpr float SIZE = 1024.0F;
+    const float wall_thickness = SIZE / static_cast<float>(1U << depth);
+    const float floor_height = SIZE / 8;
+    const float room_size = SIZE / 4;
+
+    auto root = std::make_shared<world::Cube>(world::Cube::Type::EMPTY, SIZE, glm::vec3{0.0F, 0.0F, 0.0F});
+
+    // Is the point part of a wall or the floor.
+    const auto is_solid = [&](const glm::vec3 &point) {
+        return point.y < floor_height || std::fmod(point.x, room_size) < wall_thickness ||
+               std::fmod(point.z, room_size) < wall_thickness;
+    };
+    auto generate = [&](auto &self, world::Cube &cube, const std::size_t level) -> void {
+        // A cube is uniform if all of its corners and its center agree, which is exact for the chosen layout.
+        const glm::vec3 position = cube.position();
+        const float size = cube.size();
+        const float inner = size - wall_thickness / 2;
+        const bool solid = is_solid(position + glm::vec3{size / 2, size / 2, size / 2});
+        bool uniform = true;
+        for (std::size_t idx = 0; idx < world::Cube::SUB_CUBES; idx++) {
+            const glm::vec3 corner{(idx & 4U) != 0 ? inner : 0.0F, (idx & 2U) != 0 ? inner : 0.0F,
+                                   (idx & 1U) != 0 ? inner : 0.0F};
+            uniform = uniform && is_solid(position + corner + wall_thickness / 4) == solid;
+        }
+        if (uniform || level == depth) {
+            cube.set_type(solid ? world::Cube::Type::SOLID : world::Cube::Type::EMPTY);
+            return;
+        }
+        cube.set_type(world::Cube::Type::OCTANT);
+        for (const auto &child : cube.childs()) {
+            self(self, *child, level + 1);
+        }
+    };
+    generate(generate, *root, 0);
+    return root;
+}
+
+/// Collect the polygons of an octree, invalid caches are updated.
+[[nodiscard]] inline std::vector<world::Polygon> collect_polygons(const world::Cube &cube) {
+    std::vector<world::Polygon> polygons;
+    for (const auto &cache : cube.polygons(true)) {
+        polygons.insert(polygons.end(), cache.begin(), cache.end());
+    }
+    return polygons;
+}
+
+} // namespace inexor::vulkan_renderer::tests
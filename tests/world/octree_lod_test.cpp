@@ -0,0 +1,92 @@
+#include "../world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_lod.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// An octree of size 32, whose first child is a Type::SOLID leaf. The child next to it in positive x direction is an
+/// octant, whose four childs facing the leaf are solid in their half next to the leaf. All other childs are empty.
+std::shared_ptr<Cube> leaf_next_to_octant() {
+    const auto root = std::make_shared<Cube>(Cube::Type::EMPTY, 32.0F, glm::vec3{0.0F});
+    root->set_type(Cube::Type::OCTANT);
+    for (const auto &child : root->childs()) {
+        child->set_type(Cube::Type::EMPTY);
+    }
+    root->childs()[0]->set_type(Cube::Type::SOLID);
+    const auto &octant = root->childs()[4];
+    octant->set_type(Cube::Type::OCTANT);
+    for (std::size_t idx = 0; idx < Cube::SUB_CUBES; idx++) {
+        const auto &child = octant->childs()[idx];
+        // about the order look into the octree documentation
+        if ((idx & 4U) != 0) {
+            child->set_type(Cube::Type::EMPTY);
+            continue;
+        }
+        child->set_type(Cube::Type::OCTANT);
+        for (std::size_t grandchild = 0; grandchild < Cube::SUB_CUBES; grandchild++) {
+            child->childs()[grandchild]->set_type((grandchild & 4U) == 0 ? Cube::Type::SOLID : Cube::Type::EMPTY);
+        }
+    }
+    return root;
+}
+
+/// Number of polygons which lie in the plane x = 16, the border between the leaf and the octant.
+std::size_t count_border_polygons(const std::vector<Polygon> &polygons) {
+    return static_cast<std::size_t>(std::count_if(polygons.begin(), polygons.end(), [](const Polygon &polygon) {
+        return std::all_of(polygon.begin(), polygon.end(), [](const glm::vec3 &vertex) { return vertex.x == 16.0F; });
+    }));
+}
+
+} // namespace
+
+TEST(OctreeLod, CloseOctreeIsDrawnInFullDetail) {
+    const auto cube = tests::generate_octree(4);
+    OctreeLod lod;
+    EXPECT_TRUE(lod.update(*cube, glm::vec3{16.0F}));
+    EXPECT_TRUE(std::none_of(lod.selection().begin(), lod.selection().end(),
+                             [](const OctreeLod::Selection &selected) { return selected.representative; }));
+    EXPECT_EQ(lod.polygons(), tests::collect_polygons(*cube));
+    EXPECT_FALSE(lod.update(*cube, glm::vec3{16.0F}));
+}
+
+TEST(OctreeLod, LeftOutOctantDoesNotHideFacesOfLeaves) {
+    const auto cube = leaf_next_to_octant();
+    // The octant is further away than its size, the root is not.
+    OctreeLod lod(1.0F);
+    ASSERT_TRUE(lod.update(*cube, glm::vec3{-10.0F, 8.0F, 8.0F}));
+    const auto &selection = lod.selection();
+    const auto octant = std::find_if(selection.begin(), selection.end(), [&](const OctreeLod::Selection &selected) {
+        return selected.cube == cube->childs()[4].get();
+    });
+    ASSERT_NE(octant, selection.end());
+    EXPECT_TRUE(octant->representative);
+
+    // A quarter of the octant is solid, so it is left out and the leaf is drawn with all of its faces.
+    EXPECT_EQ(lod.polygons().size(), Cube::POLYGONS);
+    EXPECT_EQ(count_border_polygons(lod.polygons()), 2);
+    // In full detail the face is hidden by the childs of the octant.
+    EXPECT_EQ(count_border_polygons(tests::collect_polygons(*cube)), 0);
+}
+
+TEST(OctreeLod, DrawnRepresentativeHidesFacesOfLeaves) {
+    const auto cube = leaf_next_to_octant();
+    for (const auto &child : cube->childs()[4]->childs()) {
+        child->set_type(Cube::Type::SOLID);
+    }
+    OctreeLod lod(1.0F);
+    ASSERT_TRUE(lod.update(*cube, glm::vec3{-10.0F, 8.0F, 8.0F}));
+    // The leaf without its face towards the octant and the representative with all of its faces.
+    EXPECT_EQ(lod.polygons().size(), 2 * Cube::POLYGONS - 2);
+    EXPECT_EQ(count_border_polygons(lod.polygons()), 2);
+}
+
+} // namespace inexor::vulkan_renderer::world
@@ -0,0 +1,53 @@
+#include "../world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_mesh.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <iterator>
+#include <tuple>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// The polygons of a mesh without the degenerated ones, sorted so they can be compared regardless of their ranges.
+std::vector<Polygon> sorted_polygons(const std::vector<Polygon> &polygons) {
+    std::vector<Polygon> result;
+    std::copy_if(polygons.begin(), polygons.end(), std::back_inserter(result),
+                 [](const Polygon &polygon) { return polygon != Polygon{}; });
+    std::sort(result.begin(), result.end(), [](const Polygon &lhs, const Polygon &rhs) {
+        return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                                            [](const glm::vec3 &lhs, const glm::vec3 &rhs) {
+                                                return std::tie(lhs.x, lhs.y, lhs.z) < std::tie(rhs.x, rhs.y, rhs.z);
+                                            });
+    });
+    return result;
+}
+
+} // namespace
+
+TEST(OctreeMesh, RemovedOctreeLeavesOnlyTheOtherOctree) {
+    const auto first = tests::generate_octree(4, 1);
+    const auto second = tests::generate_octree(4, 2);
+    OctreeMesh mesh;
+    static_cast<void>(mesh.update(*first));
+    static_cast<void>(mesh.update(*second));
+    const std::size_t polygon_count = mesh.polygons().size();
+
+    EXPECT_FALSE(mesh.remove(*first).empty());
+    EXPECT_EQ(sorted_polygons(mesh.polygons()), sorted_polygons(tests::collect_polygons(*second)));
+
+    // The released ranges are reused, so adding the octree again doesn't grow the mesh.
+    static_cast<void>(mesh.update(*first));
+    EXPECT_EQ(mesh.polygons().size(), polygon_count);
+    auto expected = tests::collect_polygons(*first);
+    const auto second_polygons = tests::collect_polygons(*second);
+    expected.insert(expected.end(), second_polygons.begin(), second_polygons.end());
+    EXPECT_EQ(sorted_polygons(mesh.polygons()), sorted_polygons(expected));
+}
+
+} // namespace inexor::vulkan_renderer::world
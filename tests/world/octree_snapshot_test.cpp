@@ -0,0 +1,70 @@
+#include "../world/octree_generator.hpp"
+
+#include "inexor/vulkan-renderer/world/cube.hpp"
+#include "inexor/vulkan-renderer/world/octree_edit_batch.hpp"
+#include "inexor/vulkan-renderer/world/octree_snapshot.hpp"
+#include "inexor/vulkan-renderer/world/octree_traversal.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+namespace inexor::vulkan_renderer::world {
+
+namespace {
+
+/// Get the first leaf of a subtree in pre-order.
+std::shared_ptr<Cube> first_leaf(const std::shared_ptr<Cube> &cube) {
+    auto leaf = cube;
+    while (leaf->type() == Cube::Type::OCTANT) {
+        leaf = leaf->childs()[0];
+    }
+    return leaf;
+}
+
+} // namespace
+
+TEST(OctreeSnapshot, SnapshotsShareUnchangedSubtrees) {
+    const auto cube = tests::generate_octree(4);
+    const auto first = cube->snapshot();
+    // Without edits the same nodes are returned.
+    EXPECT_EQ(cube->snapshot().root(), first.root());
+
+    const auto leaf = first_leaf(cube->childs()[0]);
+    leaf->set_type(leaf->type() == Cube::Type::EMPTY ? Cube::Type::SOLID : Cube::Type::EMPTY);
+    const auto second = cube->snapshot();
+
+    ASSERT_NE(second.root(), first.root());
+    EXPECT_NE(second.root()->childs[0], first.root()->childs[0]);
+    for (std::size_t idx = 1; idx < Cube::SUB_CUBES; idx++) {
+        EXPECT_EQ(second.root()->childs[idx], first.root()->childs[idx]) << "child " << idx;
+    }
+    // The first snapshot is not changed by the edit.
+    EXPECT_EQ(first.polygons(), tests::generate_octree(4)->snapshot().polygons());
+}
+
+TEST(OctreeSnapshot, RestoreUndoesEdits) {
+    const auto cube = tests::generate_octree(4);
+    const auto polygons = tests::collect_polygons(*cube);
+    const auto snapshot = cube->snapshot();
+
+    first_leaf(cube->childs()[1])->set_type(Cube::Type::OCTANT);
+    cube->childs()[2]->set_type(Cube::Type::EMPTY);
+    const auto normal = first_leaf(cube->childs()[3]);
+    normal->set_type(Cube::Type::NORMAL);
+    normal->indent(0, true, 3);
+    OctreeEditBatch batch;
+    batch.set_type(first_leaf(cube->childs()[5]), Cube::Type::SOLID);
+    batch.set_type(cube->childs()[6], Cube::Type::OCTANT);
+    static_cast<void>(batch.commit());
+    ASSERT_NE(tests::collect_polygons(*cube), polygons);
+
+    cube->restore(snapshot);
+    EXPECT_EQ(tests::collect_polygons(*cube), polygons);
+    EXPECT_EQ(tests::collect_polygons(*snapshot.to_cube()), polygons);
+    // The restored octree shares all nodes with the snapshot again.
+    EXPECT_EQ(cube->snapshot().root(), snapshot.root());
+}
+
+} // namespace inexor::vulkan_renderer::world